@@ -5,43 +5,675 @@
 #include "FindReplace.h"
 #include "../util/HashMap.h"
 #include "memory.h"
+#include <sys/mman.h>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include <unordered_set>
+#include <map>
+#include <string>
+
+// 页面内容锁，共享或独占，自旋等待。只保护页面内容，与缓存结构的分片锁相互独立。
+class Latch {
+private:
+    std::atomic<int> state; // 独占时为 -1，否则为持有共享锁的个数
+
+public:
+    Latch() : state(0) {}
+
+    void lockShared() {
+        int s = state.load(std::memory_order_relaxed);
+        while (true) {
+            if (s >= 0 && state.compare_exchange_weak(s, s + 1, std::memory_order_acquire)) return;
+            if (s < 0) {
+                std::this_thread::yield();
+                s = state.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryLockShared() {
+        int s = state.load(std::memory_order_relaxed);
+        while (s >= 0)
+            if (state.compare_exchange_weak(s, s + 1, std::memory_order_acquire)) return true;
+        return false;
+    }
+
+    void unlockShared() {
+        state.fetch_sub(1, std::memory_order_release);
+    }
+
+    void lock() {
+        int s = 0;
+        while (!state.compare_exchange_weak(s, -1, std::memory_order_acquire)) {
+            s = 0;
+            std::this_thread::yield();
+        }
+    }
+
+    void unlock() {
+        state.store(0, std::memory_order_release);
+    }
+};
+
+// 一个文件的缓存统计，文件以文件名标识，物理关闭后其统计仍保留。
+struct BufFileStats {
+    long long hits, misses;   // getPage 命中与未命中（须读盘）的次数
+    long long prefetched;     // 预读载入的页数
+    long long evictions;      // 被替换出缓存的页数
+    long long writeBacks;     // 其中为脏页、替换前须同步写回的页数
+    long long reads, writes;  // FileManager 读写的页数
+};
+
+// 缓存统计快照，由 BufPageManager::getStats 生成。
+struct BufStats {
+    int capacity, shards, dirty;
+    long long flushed;  // 后台写回线程写回的页数
+    double ioSeconds;   // FileManager 读写的总耗时
+    BufFileStats total;
+    std::map<std::string, BufFileStats> files;
+};
 
 class BufPageManager {
 private:
-    int last;
-    HashMap *hash;
-    MultiList *list;
-    FindReplace *replace;
-    int id2key[BUF_CAPACITY][2];
-    bool dirty[BUF_CAPACITY];
-    char *buf;
+    // 缓存页面的描述，16 字节，一条缓存行容纳 4 个，命中时一次访问取得页面的全部状态。
+    struct Frame {
+        int fileID, pageID;  // 载入的文件页，空闲时为 -1
+        unsigned stamp;      // 最近一次被访问的时刻（所在分片的时钟），回绕后以差值比较
+        short pinCount;
+        bool dirty;
+        unsigned char shard; // 所在分片，构造后不变
+    };
+
+    /* 缓存分片。文件页按 (文件编号, 页号所在的 BUF_SHARD_SPAN 页区段) 散列到分片，
+     * 同一区段的页面位于同一分片，批量读写仍能合并。每个分片管理一段连续的缓存页面
+     * [base, base + size)，有各自的锁、页表、替换策略、文件页面链表与脏页表；
+     * 替换策略与链表使用分片内的局部编号（页面编号减去 base）。
+     */
+    struct Shard {
+        std::mutex mutex;
+        int base, size;
+        int last;       // 最近一次 access 的局部编号
+        unsigned clock; // 本分片的访问时钟
+        HashMap<Frame> *hash;
+        MultiList *list;
+        FindReplace *replace;
+        // 脏页表：脏页面按首次变脏的先后串成链表，首次变脏的时刻记于 dirtySince。
+        // 写回、检查点与退出时由此表取得脏页，不必扫描全部缓存页面。
+        MultiList *dirtyList;
+        // 写回线程正在写的文件页，由 flushMutex 保护。等待写完时仍持有分片锁，
+        // 其他线程不会在等待期间看到未完成的读入或换出；写回线程写完后只需 flushMutex。
+        std::mutex flushMutex;
+        std::condition_variable flushCond;
+        std::unordered_set<long long> flushing;
+        bool checkpointing;
+        unsigned checkpointClock; // 本次检查点开始时的时钟，此前变脏的页面须写回
+        // 访问统计，按文件编号计数，由分片锁保护；读写页数由 FileManager 另行统计。
+        BufFileStats stats[MAX_FILE_NUM];
+        long long flushed;
+    };
+
+    // 按编号顺序锁住全部分片，用于跨分片的批量操作。持有某个分片的锁时不可再获取。
+    struct AllShards {
+        BufPageManager &pmgr;
+
+        AllShards(BufPageManager &manager) : pmgr(manager) {
+            for (int i = 0; i < pmgr.shardCount; i++) pmgr.shards[i].mutex.lock();
+        }
+
+        ~AllShards() {
+            for (int i = pmgr.shardCount - 1; i >= 0; i--) pmgr.shards[i].mutex.unlock();
+        }
+    };
+
+    // 锁住文件中连续若干页所在的分片，按编号顺序加锁，与 AllShards 一致，不会死锁。
+    struct PageShards {
+        BufPageManager &pmgr;
+        std::vector<int> ids;
+
+        PageShards(BufPageManager &manager, int fileID, int pageID, int count) : pmgr(manager) {
+            for (int i = 0; i < count; i++) ids.push_back(&pmgr.shardOf(fileID, pageID + i) - pmgr.shards);
+            std::sort(ids.begin(), ids.end());
+            ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+            for (int id : ids) pmgr.shards[id].mutex.lock();
+        }
+
+        ~PageShards() {
+            for (int i = (int) ids.size() - 1; i >= 0; i--) pmgr.shards[ids[i]].mutex.unlock();
+        }
+    };
+
+    // 启动参数：缓存页数、是否使用大页、替换策略、脏页上限与读写后端，须在首次 getInstance 之前设置。
+    static inline int configCapacity = BUF_CAPACITY;
+    static inline bool configHugePage = false;
+    static inline ReplacePolicy configPolicy = RP_LRU;
+    static inline int configHighWater = -1;
+    static inline bool configUring = true;
+    static inline int configReadAhead = READAHEAD_PAGES;
+    static inline bool configMapped = false;
+    static inline bool configDirect = false;
+    static inline int configCheckpoint = 0;
+    static inline int configShards = 0;
+
+    int pageSize;
+    int capacity;
+    int shardCount;
+    Shard *shards;
+    Frame *frame;
+    Latch *latches;
+    unsigned *dirtySince;
+    std::atomic<char*> *chunks;
+    std::mutex chunkMutex; // 分配缓存块
+    bool hugePage;
     FileManager *fileManager;
+    bool mapped; // 映射模式，页面直接位于文件映射区中，不经过缓存；压缩文件除外
+
+    // 文件级操作（打开、关闭、映射）的锁，须在分片锁之前获取。
+    std::mutex mutex;
+
+    // 已物理关闭的文件的统计，以文件名为键。持有文件级的锁与全部分片的锁时访问。
+    std::map<std::string, BufFileStats> closedStats;
+    long long flushedBefore; // 改变页大小之前的分片中后台写回的页数
+
+    // 顺序预读：记录每个文件最近访问的页号、连续顺序访问的页数与已预读到的页号，按文件加锁。
+    int readAheadPages;
+    std::mutex seqMutex[MAX_FILE_NUM];
+    int seqLast[MAX_FILE_NUM], seqRun[MAX_FILE_NUM], seqAhead[MAX_FILE_NUM];
 
+    // 后台写回线程。脏页数超过 highWater 时被唤醒，将较冷的脏页写回直至降到 lowWater。
+    // writerMutex 只用于等待与唤醒，写回线程持有它时不获取分片锁。
+    std::mutex writerMutex;
+    std::condition_variable writerCond;
+    std::thread writer;
+    std::atomic<bool> stopping;
+    std::atomic<int> dirtyCount;
+    int highWater, lowWater;
+
+    // 周期检查点：每隔 checkpointInterval 秒，写回线程开始一次检查点，
+    // 逐批写回各分片中在检查点开始前变脏的页面，期间查询照常进行。
+    int checkpointInterval;
+    std::chrono::steady_clock::time_point nextCheckpoint; // 只由写回线程访问
+
+    static long long pageKey(int fileID, int pageID) {
+        return ((long long) fileID << 32) | (unsigned int) pageID;
+    }
+
+    Shard &shardOf(int fileID, int pageID) {
+        unsigned long long key = pageKey(fileID, pageID / BUF_SHARD_SPAN);
+        return shards[(unsigned) ((key * 0x9E3779B97F4A7C15ULL) >> 32) % shardCount];
+    }
+
+    Shard &shardOf(int index) {
+        return shards[frame[index].shard];
+    }
+
+    // 分配一块按页大小对齐的缓存（O_DIRECT 读写要求对齐）。
+    // 使用大页失败时退回普通页并建议内核合并为透明大页。
+    char *allocChunk() {
+        size_t size = (size_t) BUF_CHUNK_PAGES * pageSize;
+        void *ptr = MAP_FAILED;
+        if (hugePage) {
+            ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (ptr != MAP_FAILED) return (char*) ptr;
+        }
+        ptr = mmap(nullptr, size + pageSize, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        assert(ptr != MAP_FAILED);
+        char *raw = (char*) ptr;
+        char *aligned = (char*) (((uintptr_t) raw + pageSize - 1) & ~((uintptr_t) pageSize - 1));
+        if (aligned > raw) munmap(raw, aligned - raw);
+        if (aligned + size < raw + size + pageSize) munmap(aligned + size, raw + pageSize - aligned);
+        if (hugePage) madvise(aligned, size, MADV_HUGEPAGE);
+        return aligned;
+    }
+
+    // 映射模式下文件的页面是否直接取自映射区。
+    bool isMapped(int fileID) {
+        return mapped && !fileManager->compressed[fileID];
+    }
+
+    // 缓存块可能被不同分片的页面共用，首次使用时加锁分配。
     char *getBuf(int index) {
-        return buf + index * PAGE_SIZE;
+        int chunk = index / BUF_CHUNK_PAGES;
+        char *base = chunks[chunk].load(std::memory_order_acquire);
+        if (base == nullptr) {
+            std::lock_guard<std::mutex> guard(chunkMutex);
+            base = chunks[chunk].load(std::memory_order_relaxed);
+            if (base == nullptr) {
+                base = allocChunk();
+                chunks[chunk].store(base, std::memory_order_release);
+            }
+        }
+        return base + (size_t) (index % BUF_CHUNK_PAGES) * pageSize;
     }
 
-    int fetchPage(int fileID, int pageID) {
-        int index = replace->find();
-        if (dirty[index]) {
-            int k1, k2;
-            hash->getKeys(index, k1, k2);
-            fileManager->writePage(k1, k2, getBuf(index));
-            dirty[index] = false;
+    int chunkCount() {
+        return (capacity + BUF_CHUNK_PAGES - 1) / BUF_CHUNK_PAGES;
+    }
+
+    void wakeWriter() {
+        std::lock_guard<std::mutex> guard(writerMutex);
+        writerCond.notify_one();
+    }
+
+    // 以下以 Shard 为参数的函数，调用时须持有该分片的锁。
+
+    void setDirty(Shard &sh, int index) {
+        if (frame[index].dirty) return;
+        frame[index].dirty = true;
+        sh.dirtyList->insert(0, index - sh.base);
+        dirtySince[index] = sh.clock;
+        if (++dirtyCount > highWater && highWater > 0 && writer.joinable()) wakeWriter();
+    }
+
+    void clearDirty(Shard &sh, int index) {
+        if (!frame[index].dirty) return;
+        frame[index].dirty = false;
+        sh.dirtyList->erase(index - sh.base);
+        dirtyCount--;
+    }
+
+    // 分片脏页表中的全部页面，按首次变脏的先后。
+    void dirtyFrames(Shard &sh, std::vector<int> &frames) {
+        for (int i = sh.dirtyList->getFirst(0); !sh.dirtyList->isHead(i); i = sh.dirtyList->next(i))
+            frames.push_back(sh.base + i);
+    }
+
+    // 等待写回线程写完该文件页，之后方可读写磁盘上的该页。
+    void waitFlushing(Shard &sh, int fileID, int pageID) {
+        std::unique_lock<std::mutex> lock(sh.flushMutex);
+        while (sh.flushing.count(pageKey(fileID, pageID))) sh.flushCond.wait(lock);
+    }
+
+    // 等待写回线程写完分片中某个文件（fileID 为 -1 时为任意文件）的全部页面。
+    void waitFlushingFile(Shard &sh, int fileID) {
+        std::unique_lock<std::mutex> lock(sh.flushMutex);
+        while (true) {
+            bool busy = false;
+            for (auto key : sh.flushing) if (fileID == -1 || (key >> 32) == fileID) {busy = true; break;}
+            if (!busy) break;
+            sh.flushCond.wait(lock);
         }
-        hash->replace(index, fileID, pageID);
-        list->insert(fileID, index);
+    }
+
+    void writeFrame(Shard &sh, int index) {
+        Frame &f = frame[index];
+        waitFlushing(sh, f.fileID, f.pageID);
+        fileManager->writePage(f.fileID, f.pageID, getBuf(index));
+        clearDirty(sh, index);
+    }
+
+    void readFrame(Shard &sh, int index, int fileID, int pageID) {
+        waitFlushing(sh, fileID, pageID);
+        fileManager->readPage(fileID, pageID, getBuf(index));
+    }
+
+    // 按文件与页号排序页面，使批量读写时连续的页面能够合并。
+    void sortFrames(std::vector<int> &frames) {
+        std::vector<std::pair<long long, int>> order;
+        for (int index : frames)
+            order.push_back(std::make_pair(pageKey(frame[index].fileID, frame[index].pageID), index));
+        std::sort(order.begin(), order.end());
+        for (int i = 0; i < (int) frames.size(); i++) frames[i] = order[i].second;
+    }
+
+    // 批量写回若干脏页面。调用时须持有这些页面所在分片的锁。
+    void writeFrames(std::vector<int> &frames) {
+        std::vector<PageRequest> requests;
+        sortFrames(frames);
+        for (int index : frames)
+            waitFlushing(shardOf(index), frame[index].fileID, frame[index].pageID);
+        for (int index : frames)
+            requests.push_back(fileManager->request(frame[index].fileID, frame[index].pageID, getBuf(index)));
+        fileManager->writePages(requests);
+        for (int index : frames) clearDirty(shardOf(index), index);
+    }
+
+    int fetchPage(Shard &sh, int fileID, int pageID) {
+        int index = sh.base + sh.replace->find();
+        Frame &f = frame[index];
+        if (f.fileID != -1) {
+            sh.stats[f.fileID].evictions++;
+            if (f.dirty) sh.stats[f.fileID].writeBacks++;
+        }
+        if (f.dirty) writeFrame(sh, index);
+        if (f.fileID != -1) sh.hash->erase(index);
+        f.fileID = fileID;
+        f.pageID = pageID;
+        sh.hash->insert(index);
+        sh.list->insert(fileID, index - sh.base);
+        sh.replace->load(index - sh.base, fileID, pageID);
+        f.stamp = ++sh.clock;
         return index;
     }
 
+    int lookup(Shard &sh, int fileID, int pageID) {
+        int index = sh.hash->findIndex(fileID, pageID);
+        if (index != -1) {
+            sh.stats[fileID].hits++;
+            touch(sh, index);
+        } else {
+            sh.stats[fileID].misses++;
+            index = fetchPage(sh, fileID, pageID);
+            readFrame(sh, index, fileID, pageID);
+        }
+        return index;
+    }
+
+    void touch(Shard &sh, int index) {
+        frame[index].stamp = ++sh.clock;
+        int local = index - sh.base;
+        if (local != sh.last && frame[index].pinCount == 0) {
+            sh.replace->access(local);
+            sh.last = local;
+        }
+    }
+
+    void pinFrame(Shard &sh, int index) {
+        if (frame[index].pinCount++ == 0) sh.replace->pin(index - sh.base);
+    }
+
+    void unpinFrame(Shard &sh, int index) {
+        assert(frame[index].pinCount > 0);
+        if (--frame[index].pinCount == 0) {
+            sh.replace->unpin(index - sh.base);
+            frame[index].stamp = ++sh.clock;
+            sh.last = index - sh.base;
+        }
+    }
+
+    void evict(Shard &sh, int index, bool ifWrite) {
+        Frame &f = frame[index];
+        assert(f.pinCount == 0);
+        if (f.dirty) {
+            if (ifWrite) writeFrame(sh, index);
+            else clearDirty(sh, index);
+        }
+        sh.replace->free(index - sh.base);
+        if (f.fileID != -1) sh.hash->erase(index);
+        f.fileID = f.pageID = -1;
+        sh.list->erase(index - sh.base);
+    }
+
+    // 批量读入文件中连续若干页，已缓存的页面跳过。调用时须持有这些页面所在分片的锁（PageShards）。
+    // 读入完成前固定已载入的页面，以免同一批中后面的页面换出前面的页面，使两次读入落在同一个缓存页面上。
+    void fetchPages(int fileID, int pageID, int count) {
+        std::vector<PageRequest> requests;
+        std::vector<int> frames;
+        for (int i = 0; i < count; i++) {
+            Shard &sh = shardOf(fileID, pageID + i);
+            if (sh.hash->findIndex(fileID, pageID + i) != -1) continue;
+            int index = fetchPage(sh, fileID, pageID + i);
+            pinFrame(sh, index);
+            frames.push_back(index);
+            sh.stats[fileID].prefetched++;
+            waitFlushing(sh, fileID, pageID + i);
+            requests.push_back(fileManager->request(fileID, pageID + i, getBuf(index)));
+        }
+        fileManager->readPages(requests);
+        for (int index : frames) unpinFrame(shardOf(index), index);
+    }
+
+    // 以下函数调用时须持有全部分片的锁。
+
+    void evictFile(int fileID, bool ifWrite) {
+        if (ifWrite) {
+            std::vector<int> frames;
+            for (int s = 0; s < shardCount; s++) {
+                Shard &sh = shards[s];
+                for (int i = sh.list->getFirst(fileID); !sh.list->isHead(i); i = sh.list->next(i))
+                    if (frame[sh.base + i].dirty) frames.push_back(sh.base + i);
+            }
+            writeFrames(frames);
+        }
+        for (int s = 0; s < shardCount; s++) {
+            Shard &sh = shards[s];
+            int i;
+            while (!sh.list->isHead(i = sh.list->getFirst(fileID))) evict(sh, sh.base + i, ifWrite);
+        }
+    }
+
+    // 还须持有文件级的锁。
+    void shut(int fileID, bool ifWrite) {
+        evictFile(fileID, ifWrite);
+        {
+            std::lock_guard<std::mutex> guard(seqMutex[fileID]);
+            seqLast[fileID] = -1;
+            seqRun[fileID] = seqAhead[fileID] = 0;
+        }
+        // 丢弃的页面也可能仍在写回，须等其完成再关闭文件描述符
+        for (int s = 0; s < shardCount; s++) waitFlushingFile(shards[s], fileID);
+        // 文件编号将被复用，其统计移入 closedStats
+        addStats(closedStats[fileManager->getFileName(fileID)], fileStats(fileID));
+        clearStats(fileID);
+        fileManager->shutFile(fileID, ifWrite);
+    }
+
+    static void addStats(BufFileStats &a, const BufFileStats &b) {
+        a.hits += b.hits; a.misses += b.misses; a.prefetched += b.prefetched;
+        a.evictions += b.evictions; a.writeBacks += b.writeBacks;
+        a.reads += b.reads; a.writes += b.writes;
+    }
+
+    // 汇总各分片中某个打开的文件的统计。
+    BufFileStats fileStats(int fileID) {
+        BufFileStats ret = BufFileStats();
+        for (int s = 0; s < shardCount; s++) addStats(ret, shards[s].stats[fileID]);
+        ret.reads = fileManager->pagesRead[fileID];
+        ret.writes = fileManager->pagesWritten[fileID];
+        return ret;
+    }
+
+    void clearStats(int fileID) {
+        for (int s = 0; s < shardCount; s++) shards[s].stats[fileID] = BufFileStats();
+        fileManager->pagesRead[fileID] = fileManager->pagesWritten[fileID] = 0;
+    }
+
+    // 连续 READAHEAD_TRIGGER 次顺序访问后，每当访问进入已预读窗口的后半段，预读其后 readAheadPages 页。
+    // 调用时不持有任何分片的锁。
+    void readAhead(int fileID, int pageID) {
+        int start, end;
+        {
+            std::lock_guard<std::mutex> guard(seqMutex[fileID]);
+            if (pageID == seqLast[fileID]) return;
+            if (pageID == seqLast[fileID] + 1) seqRun[fileID]++;
+            else seqRun[fileID] = seqAhead[fileID] = 0;
+            seqLast[fileID] = pageID;
+            if (seqRun[fileID] < READAHEAD_TRIGGER) return;
+            if (pageID + readAheadPages / 2 < seqAhead[fileID]) return;
+            start = std::max(pageID + 1, seqAhead[fileID]);
+            end = std::min(pageID + 1 + readAheadPages, fileManager->getPageCount(fileID));
+            seqAhead[fileID] = pageID + 1 + readAheadPages;
+        }
+        if (start >= end) return;
+        PageShards locked(*this, fileID, start, end - start);
+        fetchPages(fileID, start, end - start);
+    }
+
+    // 超过脏页上限时选出分片中写回的页面：最久未被访问的若干冷脏页。
+    void pickCold(Shard &sh, std::vector<int> &selected) {
+        std::vector<std::pair<unsigned, int>> candidates;
+        for (int i = sh.dirtyList->getFirst(0); !sh.dirtyList->isHead(i); i = sh.dirtyList->next(i)) {
+            int index = sh.base + i;
+            unsigned age = sh.clock - frame[index].stamp;
+            candidates.push_back(std::make_pair(~age, index)); // 升序即最久未访问的在前
+        }
+        int n = std::min((int) candidates.size(), std::max((dirtyCount - lowWater) / shardCount, 1));
+        if (n > BUF_WRITER_BATCH) n = BUF_WRITER_BATCH;
+        std::partial_sort(candidates.begin(), candidates.begin() + n, candidates.end());
+        for (int i = 0; i < n; i++) selected.push_back(candidates[i].second);
+    }
+
+    // 检查点进行中时选出分片的下一批页面：按变脏先后取检查点开始前变脏的页面。
+    // 没有可写的页面时分片的本次检查点结束。
+    void pickCheckpoint(Shard &sh, std::vector<int> &selected) {
+        for (int i = sh.dirtyList->getFirst(0); !sh.dirtyList->isHead(i); i = sh.dirtyList->next(i)) {
+            int index = sh.base + i;
+            if ((int) (dirtySince[index] - sh.checkpointClock) > 0) break;
+            selected.push_back(index);
+            if ((int) selected.size() == BUF_WRITER_BATCH) return;
+        }
+        if (selected.size() == 0) sh.checkpointing = false;
+    }
+
+    // 写回分片中的一批页面，返回写回的页数。被选中的页面在持锁时复制出来并标记为干净，
+    // 解锁后再写入磁盘，因而写盘期间查询线程可以继续访问缓存。内容被独占锁住的页面跳过。
+    int flushShard(Shard &sh, char *buffer) {
+        int keys[BUF_WRITER_BATCH][2];
+        std::vector<int> selected;
+        std::vector<PageRequest> requests;
+        std::unique_lock<std::mutex> lock(sh.mutex);
+        if (sh.checkpointing) pickCheckpoint(sh, selected);
+        if (selected.size() == 0 && highWater > 0 && dirtyCount > highWater) pickCold(sh, selected);
+        sortFrames(selected);
+        int n = 0;
+        for (int index : selected) {
+            if (!latches[index].tryLockShared()) continue;
+            char *copy = buffer + (size_t) n * pageSize;
+            keys[n][0] = frame[index].fileID;
+            keys[n][1] = frame[index].pageID;
+            memcpy(copy, getBuf(index), pageSize);
+            latches[index].unlockShared();
+            clearDirty(sh, index);
+            {
+                std::lock_guard<std::mutex> guard(sh.flushMutex);
+                sh.flushing.insert(pageKey(keys[n][0], keys[n][1]));
+            }
+            requests.push_back(fileManager->request(keys[n][0], keys[n][1], copy));
+            n++;
+        }
+        sh.flushed += n;
+        lock.unlock();
+        if (n == 0) return 0;
+        fileManager->writePages(requests);
+        std::lock_guard<std::mutex> guard(sh.flushMutex);
+        for (int i = 0; i < n; i++) sh.flushing.erase(pageKey(keys[i][0], keys[i][1]));
+        sh.flushCond.notify_all();
+        return n;
+    }
+
+    // 写回线程主循环，轮流处理各个分片，每次只持有一个分片的锁。表与索引只在 PageGuard 的独占锁内
+    // 修改页面并标记为脏，复制时持有共享锁即可得到完整的页面，因此不必回避最近用过或被固定的页面。
+    void writerMain() {
+        char *buffer = (char*) aligned_alloc(pageSize, (size_t) BUF_WRITER_BATCH * pageSize);
+        while (!stopping) {
+            if (checkpointInterval > 0 && std::chrono::steady_clock::now() >= nextCheckpoint) {
+                nextCheckpoint = std::chrono::steady_clock::now() + std::chrono::seconds(checkpointInterval);
+                for (int s = 0; s < shardCount; s++) {
+                    std::lock_guard<std::mutex> guard(shards[s].mutex);
+                    shards[s].checkpointing = true;
+                    shards[s].checkpointClock = shards[s].clock;
+                }
+            }
+            int written = 0;
+            for (int s = 0; s < shardCount; s++) written += flushShard(shards[s], buffer);
+            if (written > 0) continue;
+            std::unique_lock<std::mutex> lock(writerMutex);
+            if (stopping) break;
+            if (highWater > 0 && dirtyCount > highWater)
+                writerCond.wait_for(lock, std::chrono::milliseconds(10));
+            else if (checkpointInterval > 0) writerCond.wait_until(lock, nextCheckpoint);
+            else writerCond.wait(lock);
+        }
+        ::free(buffer);
+    }
+
+    // 按页大小建立缓存：缓存的字节数固定为 configCapacity 个 PAGE_SIZE 页，页面越大页数越少。
+    void build(int size) {
+        pageSize = size;
+        capacity = std::max((int) ((long long) configCapacity * PAGE_SIZE / pageSize), 16);
+        chunks = new std::atomic<char*>[chunkCount()];
+        for (int i = 0; i < chunkCount(); i++) chunks[i].store(nullptr);
+        frame = new Frame[capacity];
+        latches = new Latch[capacity];
+        dirtySince = new unsigned[capacity]();
+        // 未指定分片数时，在每个分片不少于 BUF_SHARD_MIN_PAGES 页的前提下取至多 BUF_MAX_SHARDS 个
+        shardCount = 1;
+        if (configShards > 0) shardCount = std::min(configShards, 255);
+        else while (shardCount * 2 <= BUF_MAX_SHARDS && capacity / (shardCount * 2) >= BUF_SHARD_MIN_PAGES)
+            shardCount *= 2;
+        shardCount = std::max(1, std::min(shardCount, capacity / 16));
+        shards = new Shard[shardCount];
+        for (int s = 0; s < shardCount; s++) {
+            Shard &sh = shards[s];
+            sh.base = (long long) capacity * s / shardCount;
+            sh.size = (long long) capacity * (s + 1) / shardCount - sh.base;
+            sh.last = -1;
+            sh.clock = 0;
+            sh.hash = new HashMap<Frame>(sh.size, frame);
+            sh.list = new MultiList(sh.size, MAX_FILE_NUM);
+            sh.replace = FindReplace::create(configPolicy, sh.size);
+            sh.dirtyList = new MultiList(sh.size, 1);
+            sh.checkpointing = false;
+            std::fill(sh.stats, sh.stats + MAX_FILE_NUM, BufFileStats());
+            sh.flushed = 0;
+            for (int i = sh.base; i < sh.base + sh.size; i++) {
+                frame[i].fileID = frame[i].pageID = -1;
+                frame[i].stamp = 0;
+                frame[i].pinCount = 0;
+                frame[i].dirty = false;
+                frame[i].shard = s;
+            }
+        }
+        readAheadPages = std::min(configReadAhead, capacity / shardCount / 8);
+        dirtyCount = 0;
+        if (configHighWater < 0) highWater = capacity / BUF_WRITER_FRACTION;
+        else highWater = std::min(configHighWater, capacity);
+        lowWater = highWater * 3 / 4;
+    }
+
+    // 释放缓存，调用时缓存中不能有页面，写回线程须已停止。
+    void teardown() {
+        for (int s = 0; s < shardCount; s++) {
+            flushedBefore += shards[s].flushed;
+            delete shards[s].hash;
+            delete shards[s].list;
+            delete shards[s].replace;
+            delete shards[s].dirtyList;
+        }
+        delete[] shards;
+        delete[] frame;
+        delete[] latches;
+        delete[] dirtySince;
+        for (int i = 0; i < chunkCount(); i++)
+            if (chunks[i] != nullptr) munmap(chunks[i], (size_t) BUF_CHUNK_PAGES * pageSize);
+        delete[] chunks;
+    }
+
+    void startWriter() {
+        stopping = false;
+        nextCheckpoint = std::chrono::steady_clock::now() + std::chrono::seconds(checkpointInterval);
+        if ((highWater > 0 || checkpointInterval > 0) && !mapped)
+            writer = std::thread(&BufPageManager::writerMain, this);
+    }
+
+    void stopWriter() {
+        if (!writer.joinable()) return;
+        {
+            std::lock_guard<std::mutex> guard(writerMutex);
+            stopping = true;
+        }
+        writerCond.notify_one();
+        writer.join();
+    }
+
     BufPageManager() {
-        buf = new char[BUF_CAPACITY * PAGE_SIZE];
-        fileManager = new FileManager;
-        replace = new FindReplace();
-        hash = new HashMap(BUF_CAPACITY);
-        list = new MultiList(BUF_CAPACITY, MAX_FILE_NUM);
-        last = -1;
-        memset(dirty, 0, sizeof(dirty));
+        hugePage = configHugePage;
+        fileManager = new FileManager(configUring, configMapped, configDirect && !configMapped);
+        mapped = configMapped;
+        for (int i = 0; i < MAX_FILE_NUM; i++) {
+            seqLast[i] = -1;
+            seqRun[i] = seqAhead[i] = 0;
+        }
+        flushedBefore = 0;
+        checkpointInterval = configCheckpoint;
+        build(PAGE_SIZE);
+        startWriter();
     }
 
     BufPageManager(BufPageManager const &);
@@ -49,14 +681,63 @@ private:
     BufPageManager &operator=(BufPageManager const &);
 
     ~BufPageManager() {
-        delete replace;
-        delete hash;
-        delete list;
+        stopWriter();
+        teardown();
         delete fileManager;
-        delete buf;
     }
 
 public:
+    /** 设置缓存参数，须在首次 getInstance 之前调用。
+     * @param pages 缓存页数。
+     * @param huge 是否尝试使用大页。
+     * @param policy 缓存替换策略。
+     * @param high 脏页数上限，超过后由后台线程写回。为负（默认）时取缓存页数的 1/BUF_WRITER_FRACTION，为0时不启动后台线程。
+     * @param uring 批量读写是否使用 io_uring，不可用时自动退回 pread/pwrite。
+     * */
+    static void configure(int pages, bool huge, ReplacePolicy policy = RP_LRU, int high = 0, bool uring = true) {
+        configCapacity = pages;
+        configHugePage = huge;
+        configPolicy = policy;
+        configHighWater = high;
+        configUring = uring;
+    }
+
+    /** 设置顺序预读的页数，须在首次 getInstance 之前调用。
+     * @param pages 每次预读的页数，为0时不预读。实际不超过每个分片页数的 1/8。
+     * */
+    static void configureReadAhead(int pages) {
+        configReadAhead = pages;
+    }
+
+    /** 设置是否使用映射模式，须在首次 getInstance 之前调用。
+     * 映射模式下 getPage 直接返回文件映射区中的指针，页面缓存编号为 -1，
+     * markDirty、pin 等对其无操作，修改在关闭文件或退出时以 msync 写回。压缩文件不映射，仍经过缓存。
+     * */
+    static void configureMapped(bool map) {
+        configMapped = map;
+    }
+
+    /** 设置是否以 O_DIRECT 打开文件，须在首次 getInstance 之前调用。
+     * 读写绕过内核页缓存，缓存页面成为唯一的缓存，可将缓存页数设为内存的大部分。映射模式下无效。
+     * */
+    static void configureDirect(bool direct) {
+        configDirect = direct;
+    }
+
+    /** 设置周期检查点，须在首次 getInstance 之前调用。
+     * @param seconds 每隔若干秒由后台线程写回此前变脏的页面，为0时不做周期检查点。映射模式下无效。
+     * */
+    static void configureCheckpoint(int seconds) {
+        configCheckpoint = seconds;
+    }
+
+    /** 设置缓存分片数，须在首次 getInstance 之前调用。
+     * @param count 分片数，为0时按缓存页数自动选取。每个分片至少16页。
+     * */
+    static void configureShards(int count) {
+        configShards = count;
+    }
+
     static BufPageManager &getInstance() {
         static BufPageManager instance;
         return instance;
@@ -67,29 +748,28 @@ public:
     }
 
     int allocPage(int fileID, int pageID, bool ifRead = false) {
-        int index = fetchPage(fileID, pageID);
+        Shard &sh = shardOf(fileID, pageID);
+        std::lock_guard<std::mutex> guard(sh.mutex);
+        int index = fetchPage(sh, fileID, pageID);
         if (ifRead) {
-            fileManager->readPage(fileID, pageID, getBuf(index));
+            readFrame(sh, index, fileID, pageID);
         }
         return index;
     }
 
     int getPage(int fileID, int pageID) {
-        int index = hash->findIndex(fileID, pageID);
-        if (index != -1) {
-            access(index);
-        } else {
-            index = fetchPage(fileID, pageID);
-            fileManager->readPage(fileID, pageID, getBuf(index));
-        }
-        return index;
+        // 先预读再查找：预读会载入并换出页面，若在查找之后进行，可能换出刚取得的页面
+        if (readAheadPages > 0) readAhead(fileID, pageID);
+        Shard &sh = shardOf(fileID, pageID);
+        std::lock_guard<std::mutex> guard(sh.mutex);
+        return lookup(sh, fileID, pageID);
     }
 
     char *access(int index) {
-        if (index != last) {
-            replace->access(index);
-            last = index;
-        }
+        assert(index >= 0);
+        Shard &sh = shardOf(index);
+        std::lock_guard<std::mutex> guard(sh.mutex);
+        touch(sh, index);
         return getBuf(index);
     }
 
@@ -97,55 +777,264 @@ public:
 
     char* getPage(int fileID, int pageID, int& pageBuffer) {
         //cout << "get page " << fileID << " " << pageID << endl;
+        if (isMapped(fileID)) {
+            pageBuffer = -1;
+            // 已映射的页面直接返回映射区中的指针，只有扩展文件或映射区时才加锁
+            char* page = fileManager->mappedPage(fileID, pageID);
+            if (page != nullptr) return page;
+            std::lock_guard<std::mutex> guard(mutex);
+            return fileManager->mapPage(fileID, pageID);
+        }
         pageBuffer = getPage(fileID, pageID);
-        char* page = access(pageBuffer);
-        //printf("%8x, %8x, %8x, %8x, %8x, %8x, %8x, %8x\n", 
+        char* page = getBuf(pageBuffer);
+        //printf("%8x, %8x, %8x, %8x, %8x, %8x, %8x, %8x\n",
         //    VI(page), VI(page+4), VI(page+8), VI(page+12), VI(page+16), VI(page+20), VI(page+24), VI(page+28));
         return page;
     }
 
+    // 读取并固定页面，两者在同一次加锁中完成，其间页面不会被其他线程换出。
+    char* getPinnedPage(int fileID, int pageID, int& pageBuffer) {
+        if (isMapped(fileID)) return getPage(fileID, pageID, pageBuffer);
+        {
+            Shard &sh = shardOf(fileID, pageID);
+            std::lock_guard<std::mutex> guard(sh.mutex);
+            pageBuffer = lookup(sh, fileID, pageID);
+            pinFrame(sh, pageBuffer);
+        }
+        if (readAheadPages > 0) readAhead(fileID, pageID);
+        return getBuf(pageBuffer);
+    }
+
     void markDirty(int index) {
-        dirty[index] = true;
-        access(index);
+        if (index < 0) return;
+        Shard &sh = shardOf(index);
+        std::lock_guard<std::mutex> guard(sh.mutex);
+        setDirty(sh, index);
+        touch(sh, index);
+    }
+
+    // 固定页面，使其在 unpin 之前不会被换出。可重复固定。
+    void pin(int index) {
+        if (index < 0) return;
+        Shard &sh = shardOf(index);
+        std::lock_guard<std::mutex> guard(sh.mutex);
+        pinFrame(sh, index);
+    }
+
+    void unpin(int index) {
+        if (index < 0) return;
+        Shard &sh = shardOf(index);
+        std::lock_guard<std::mutex> guard(sh.mutex);
+        unpinFrame(sh, index);
+    }
+
+    /** 锁住页面内容，读时用共享锁，写时用独占锁。页面须已被固定。映射模式下无操作。
+     * 写回线程不复制内容被独占锁住的页面。
+     * */
+    void latch(int index, bool exclusive) {
+        if (index < 0) return;
+        if (exclusive) latches[index].lock();
+        else latches[index].lockShared();
+    }
+
+    void unlatch(int index, bool exclusive) {
+        if (index < 0) return;
+        if (exclusive) latches[index].unlock();
+        else latches[index].unlockShared();
     }
 
     // withdraw without writeback
     void release(int index) {
-        dirty[index] = false;
-        replace->free(index);
-        hash->erase(index);
-        list->erase(index);
+        if (index < 0) return;
+        Shard &sh = shardOf(index);
+        std::lock_guard<std::mutex> guard(sh.mutex);
+        evict(sh, index, false);
     }
 
     void writeBack(int index) {
-        if (dirty[index]) {
-            int f, p;
-            hash->getKeys(index, f, p);
-            char* page = getBuf(index);
-            //cout << "write back " << f << " " << p << endl;
-            fileManager->writePage(f, p, page);
-            dirty[index] = false;
-        }
-        replace->free(index);
-        hash->erase(index);
-        list->erase(index);
+        if (index < 0) return;
+        Shard &sh = shardOf(index);
+        std::lock_guard<std::mutex> guard(sh.mutex);
+        evict(sh, index, true);
     }
 
     void closeFile(int fileID, bool ifWrite = true) {
-        int index;
-        while (!list->isHead(index = list->getFirst(fileID))) {
-            if (ifWrite) {
-                writeBack(index);
-            } else {
-                release(index);
-            }
+        AllShards all(*this);
+        evictFile(fileID, ifWrite);
+    }
+
+    // 打开文件，文件编号用尽时回收最早被逻辑关闭的文件。
+    int openFile(const char* name) {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (fileManager->findFile(name) == -1 && fileManager->isFull()) {
+            int idle = fileManager->getIdleFile();
+            assert(idle != -1);
+            AllShards all(*this);
+            shut(idle, true);
+        }
+        return fileManager->openFile(name);
+    }
+
+    // 写回（或丢弃）文件的所有缓存页面，并物理关闭文件。
+    void shutFile(int fileID, bool ifWrite = true) {
+        std::lock_guard<std::mutex> guard(mutex);
+        AllShards all(*this);
+        shut(fileID, ifWrite);
+    }
+
+    // 文件被删除或重命名前调用，使缓存中不再保留该文件。
+    void forgetFile(const char* name, bool ifWrite) {
+        std::lock_guard<std::mutex> guard(mutex);
+        int fileID = fileManager->findFile(name);
+        if (fileID == -1) return;
+        AllShards all(*this);
+        shut(fileID, ifWrite);
+    }
+
+    // 删除目录前调用，丢弃目录下所有文件的缓存。
+    void forgetDirectory(const std::string& dir) {
+        std::lock_guard<std::mutex> guard(mutex);
+        AllShards all(*this);
+        std::string prefix = dir + "/";
+        for (int i = 0; i < MAX_FILE_NUM; i++) {
+            if (!fileManager->isOpen[i]) continue;
+            if (fileManager->fileName[i].compare(0, prefix.length(), prefix) == 0)
+                shut(i, false);
+        }
+    }
+
+    /** 将文件中连续若干页批量读入缓存，已缓存的页面跳过。
+     * @param fileID 文件编号。
+     * @param pageID 起始页号。
+     * @param count 页数，至多为每个分片页数的 1/8。
+     * */
+    void prefetch(int fileID, int pageID, int count) {
+        if (isMapped(fileID)) return;
+        count = std::min(count, capacity / shardCount / 8);
+        PageShards locked(*this, fileID, pageID, count);
+        fetchPages(fileID, pageID, count);
+    }
+
+    /** 检查点：写回脏页表中的全部页面并同步到磁盘，之后磁盘上的文件包含此前的全部修改。
+     * 在语句之间由查询线程调用。
+     * @return 写回的页数。
+     * */
+    int checkpoint() {
+        std::lock_guard<std::mutex> guard(mutex);
+        std::vector<int> frames;
+        {
+            AllShards all(*this);
+            for (int s = 0; s < shardCount; s++) dirtyFrames(shards[s], frames);
+            writeFrames(frames);
+            for (int s = 0; s < shardCount; s++) waitFlushingFile(shards[s], -1);
         }
+        for (int i = 0; i < MAX_FILE_NUM; i++)
+            if (fileManager->isOpen[i]) fileManager->syncFile(i);
+        return frames.size();
+    }
+
+    // 汇总缓存统计。映射模式下不经过缓存，只有文件数与空的计数。
+    BufStats getStats() {
+        std::lock_guard<std::mutex> guard(mutex);
+        AllShards all(*this);
+        BufStats ret;
+        ret.capacity = capacity;
+        ret.shards = shardCount;
+        ret.dirty = dirtyCount;
+        ret.flushed = flushedBefore;
+        for (int s = 0; s < shardCount; s++) ret.flushed += shards[s].flushed;
+        ret.ioSeconds = fileManager->ioNanos * 1e-9;
+        ret.files = closedStats;
+        for (int i = 0; i < MAX_FILE_NUM; i++)
+            if (fileManager->isOpen[i]) addStats(ret.files[fileManager->getFileName(i)], fileStats(i));
+        ret.total = BufFileStats();
+        for (auto &item : ret.files) addStats(ret.total, item.second);
+        return ret;
+    }
+
+    // 清零全部缓存统计。
+    void resetStats() {
+        std::lock_guard<std::mutex> guard(mutex);
+        AllShards all(*this);
+        closedStats.clear();
+        for (int i = 0; i < MAX_FILE_NUM; i++) clearStats(i);
+        for (int s = 0; s < shardCount; s++) shards[s].flushed = 0;
+        flushedBefore = 0;
+        fileManager->resetStats();
     }
 
     void close() {
-        for (int i = 0; i < BUF_CAPACITY; ++i) {
-            writeBack(i);
+        std::lock_guard<std::mutex> guard(mutex);
+        if (mapped) {
+            for (int i = 0; i < MAX_FILE_NUM; i++)
+                if (fileManager->isOpen[i] && !fileManager->isCompressed(i)) fileManager->syncFile(i);
         }
+        AllShards all(*this);
+        std::vector<int> frames;
+        for (int s = 0; s < shardCount; s++) dirtyFrames(shards[s], frames);
+        writeFrames(frames);
+        for (int i = 0; i < capacity; ++i) {
+            evict(shardOf(i), i, true);
+        }
+        for (int s = 0; s < shardCount; s++) waitFlushingFile(shards[s], -1);
+    }
+
+    int getPageSize() {
+        return pageSize;
+    }
+
+    /** 改变页大小，在切换数据库时调用。所有打开的文件先写回并物理关闭，缓存按新的页大小重建，
+     * 缓存的字节数不变。调用时不能有被固定的页面。
+     * @param size 页大小，为 MIN_PAGE_SIZE 到 MAX_PAGE_SIZE 之间的 2 的幂。
+     * */
+    void setPageSize(int size) {
+        if (size == pageSize) return;
+        stopWriter();
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            {
+                AllShards all(*this);
+                for (int i = 0; i < MAX_FILE_NUM; i++)
+                    if (fileManager->isOpen[i]) shut(i, true);
+            }
+            teardown();
+            fileManager->setPageSize(size);
+            build(size);
+        }
+        startWriter();
+    }
+};
+
+// 页面守卫：构造时读取并固定页面、锁住页面内容，析构时解锁并解除固定，其间页面指针始终有效。
+// 内容锁不可重入，同一页面上的守卫不能嵌套。
+class PageGuard {
+private:
+    BufPageManager &pmgr;
+    int bufIndex;
+    char *page;
+    bool exclusive;
+
+public:
+    PageGuard(BufPageManager &manager, int fileID, int pageID, bool exclusive = true) : pmgr(manager), exclusive(exclusive) {
+        page = pmgr.getPinnedPage(fileID, pageID, bufIndex);
+        pmgr.latch(bufIndex, exclusive);
+    }
+
+    ~PageGuard() {
+        pmgr.unlatch(bufIndex, exclusive);
+        pmgr.unpin(bufIndex);
+    }
+
+    PageGuard(PageGuard const &) = delete;
+
+    PageGuard &operator=(PageGuard const &) = delete;
+
+    char *get() {
+        return page;
+    }
+
+    int index() {
+        return bufIndex;
     }
 };
 
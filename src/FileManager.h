@@ -2,13 +2,21 @@
 #define __FILE_MANAGER_H__
 
 #include "constants.h"
+#include "PageIO.h"
+#include "PageCodec.h"
 #include <cstdio>
 #include <cassert>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/stat.h>
 #include <map>
+#include <string>
 #include <fstream>
 #include <cstring>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <sys/mman.h>
 
 class FileManager {
     friend class BufPageManager;
@@ -17,18 +25,58 @@ class FileManager {
     int filePermID[MAX_FILE_NUM];
     int idStack[MAX_FILE_NUM];
     bool isOpen[MAX_FILE_NUM];
+    int refCount[MAX_FILE_NUM]; // 逻辑上打开该文件的句柄数，为0时文件保持打开以便缓存页面
+    int lastClosed[MAX_FILE_NUM];
+    std::string fileName[MAX_FILE_NUM];
+    std::map<std::string, int> openedFiles;
     int idStackTop;
+    int closeClock;
     std::map<std::string, int> permID;
     std::map<int, int> perm2temp;
     int nextID;
+    PageIO *io;
+    // 映射模式：每个文件预留一段地址空间，按块映射文件内容，页面指针直接指向映射区。
+    bool mapMode;
+    char *mapBase[MAX_FILE_NUM];
+    int mappedPages[MAX_FILE_NUM];
+    int filePages[MAX_FILE_NUM];
+    // 已映射且不超出文件末尾的页数，扩展完成后才发布，读取时不加锁。
+    std::atomic<int> readyPages[MAX_FILE_NUM];
 
-    FileManager() {
+    bool directMode; // 以 O_DIRECT 打开文件，绕过内核页缓存
+    // 页大小及其对数，所有打开的文件使用同一页大小，只在没有打开的文件时由 BufPageManager 改变。
+    int pageSize, pageIdx;
+    // 压缩文件：第 0 页以压缩形式存储，打开时据此识别。页面写回时压缩、读入时解压，不能映射。
+    bool compressed[MAX_FILE_NUM];
+
+    // 读写统计：每个文件编号读写的页数与全部读写的耗时，写回线程与查询线程并发累加。
+    std::atomic<long long> pagesRead[MAX_FILE_NUM], pagesWritten[MAX_FILE_NUM];
+    std::atomic<long long> ioNanos;
+
+    static long long nanoTime() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    FileManager(bool uring, bool mapped, bool direct) {
+        io = PageIO::create(uring);
+        mapMode = mapped;
+        directMode = direct;
+        pageSize = PAGE_SIZE;
+        pageIdx = PAGE_IDX;
+        memset(mapBase, 0, sizeof(mapBase));
+        for (int i = 0; i < MAX_FILE_NUM; i++) readyPages[i] = 0;
+        memset(compressed, 0, sizeof(compressed));
         idStackTop = 0;
         for (int i = MAX_FILE_NUM - 1; i >= 0; i--) {
             idStack[idStackTop++] = i;
         }
         memset(isOpen, 0, sizeof(isOpen));
+        memset(refCount, 0, sizeof(refCount));
+        memset(lastClosed, 0, sizeof(lastClosed));
         nextID = 0;
+        closeClock = 0;
+        resetStats();
 
         std::ifstream stm("perm.id");
         if (stm.is_open()) {
@@ -42,6 +90,7 @@ class FileManager {
     }
 
     ~FileManager() {
+        delete io;
         std::ofstream stm("perm.id");
         for (auto itm : permID) {
             stm << itm.first << " " << itm.second << "\n";
@@ -49,37 +98,224 @@ class FileManager {
     }
 
 public:
+    // 将写请求中压缩文件的页面编码，编码结果存于返回的缓冲区（每个请求一页），没有压缩文件时返回 nullptr。
+    // stored 返回每个页面实际占用的字节数。写到文件末尾之外的页面仍写满一页，使文件长度包含整页。
+    char *encodeRequests(std::vector<PageRequest> &requests, std::vector<int> &stored) {
+        char *buffer = nullptr;
+        int sizeFile = -1;
+        off_t size = 0;
+        stored.assign(requests.size(), pageSize);
+        for (size_t i = 0; i < requests.size(); i++) {
+            PageRequest &r = requests[i];
+            if (!compressed[r.fileID]) continue;
+            if (buffer == nullptr) buffer = (char*) aligned_alloc(pageSize, requests.size() * pageSize);
+            if (r.fileID != sizeFile) {
+                struct stat st;
+                size = fstat(r.fd, &st) == 0 ? st.st_size : 0;
+                sizeFile = r.fileID;
+            }
+            char *out = buffer + i * pageSize;
+            int len = PageCodec::encodePage(r.buf, pageSize, out, r.offset == 0);
+            if (len < 0) {
+                assert(r.offset != 0);
+                continue;
+            }
+            stored[i] = len;
+            if (r.offset + pageSize > size) {
+                memset(out + len, 0, pageSize - len);
+                len = pageSize;
+            }
+            r.buf = out;
+            r.len = len;
+        }
+        return buffer;
+    }
+
+    // 回收压缩页面之后不再使用的块。文件系统不支持时旧数据留在原处，读入时被忽略。
+    void punchHoles(std::vector<PageRequest> &requests, std::vector<int> &stored) {
+        for (size_t i = 0; i < requests.size(); i++)
+            if (stored[i] < pageSize)
+                fallocate(requests[i].fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                    requests[i].offset + stored[i], pageSize - stored[i]);
+    }
+
+    // 使用 pread/pwrite，不依赖文件偏移，可与后台写回线程并发。
     void writePage(int fileID, int pageID, char *buf) {
         assert(0 <= fileID && fileID < MAX_FILE_NUM && isOpen[fileID]);
+        if (compressed[fileID]) {
+            std::vector<PageRequest> requests(1, request(fileID, pageID, buf));
+            writePages(requests);
+            return;
+        }
         int file = fileList[fileID];
         off_t offset = pageID;
-        offset <<= PAGE_IDX;
-        assert(lseek(file, offset, SEEK_SET) == offset);
-        assert(write(file, (void *) buf, PAGE_SIZE) == PAGE_SIZE);
+        offset <<= pageIdx;
+        long long start = nanoTime();
+        assert(pwrite(file, (void *) buf, pageSize, offset) == pageSize);
+        ioNanos += nanoTime() - start;
+        pagesWritten[fileID]++;
     }
 
     void readPage(int fileID, int pageID, char *buf) {
         assert(0 <= fileID && fileID < MAX_FILE_NUM && isOpen[fileID]);
         int file = fileList[fileID];
         off_t offset = pageID;
-        offset <<= PAGE_IDX;
-        assert(lseek(file, offset, SEEK_SET) == offset);
-        read(file, (void *) buf, PAGE_SIZE);
-        //assert(read(file, (void *) buf, PAGE_SIZE) == PAGE_SIZE);
+        offset <<= pageIdx;
+        long long start = nanoTime();
+        ssize_t res = pread(file, (void *) buf, pageSize, offset);
+        assert(res >= 0);
+        // 文件末尾之外的部分读作全零
+        if (res < pageSize) memset(buf + res, 0, pageSize - res);
+        if (compressed[fileID]) PageCodec::decodePage(buf, pageSize);
+        ioNanos += nanoTime() - start;
+        pagesRead[fileID]++;
+    }
+
+    bool isMapped() {
+        return mapMode;
+    }
+
+    int getPageSize() {
+        return pageSize;
+    }
+
+    // 改变页大小，调用时不能有打开的文件。
+    void setPageSize(int size) {
+        for (int i = 0; i < MAX_FILE_NUM; i++) assert(!isOpen[i]);
+        pageSize = size;
+        for (pageIdx = 0; (1 << pageIdx) < size; pageIdx++);
+        assert((1 << pageIdx) == size);
+    }
+
+    // 映射模式下返回页面在映射区中的地址。访问文件末尾之外的页面时将文件扩展到该页。
+    char *mapPage(int fileID, int pageID) {
+        assert(0 <= fileID && fileID < MAX_FILE_NUM && isOpen[fileID] && !compressed[fileID]);
+        assert(pageID < MMAP_RESERVE_PAGES);
+        if (mapBase[fileID] == nullptr) {
+            void *ptr = mmap(nullptr, (size_t) MMAP_RESERVE_PAGES * pageSize, PROT_NONE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            assert(ptr != MAP_FAILED);
+            mapBase[fileID] = (char*) ptr;
+            mappedPages[fileID] = 0;
+            filePages[fileID] = getPageCount(fileID);
+        }
+        if (pageID >= filePages[fileID]) {
+            off_t size = pageID + 1;
+            int res = ftruncate(fileList[fileID], size << pageIdx);
+            assert(res == 0);
+            filePages[fileID] = pageID + 1;
+        }
+        while (pageID >= mappedPages[fileID]) {
+            off_t offset = mappedPages[fileID];
+            offset <<= pageIdx;
+            void *ptr = mmap(mapBase[fileID] + offset, (size_t) MMAP_CHUNK_PAGES * pageSize,
+                PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fileList[fileID], offset);
+            assert(ptr != MAP_FAILED);
+            mappedPages[fileID] += MMAP_CHUNK_PAGES;
+        }
+        readyPages[fileID].store(std::min(filePages[fileID], mappedPages[fileID]), std::memory_order_release);
+        return mapBase[fileID] + ((size_t) pageID << pageIdx);
+    }
+
+    // 映射模式下不加锁取得已映射页面的地址；页面尚未映射或超出文件末尾时返回 nullptr，
+    // 此时调用者须在文件级的锁内调用 mapPage。
+    char *mappedPage(int fileID, int pageID) {
+        if (pageID >= readyPages[fileID].load(std::memory_order_acquire)) return nullptr;
+        return mapBase[fileID] + ((size_t) pageID << pageIdx);
+    }
+
+    // 将文件的修改同步到磁盘：已映射的文件同步映射区，否则同步文件描述符。
+    void syncFile(int fileID) {
+        assert(isOpen[fileID]);
+        if (mapBase[fileID] != nullptr) msync(mapBase[fileID], (size_t) filePages[fileID] << pageIdx, MS_SYNC);
+        else fdatasync(fileList[fileID]);
+    }
+
+    void unmapFile(int fileID, bool ifWrite) {
+        if (mapBase[fileID] == nullptr) return;
+        if (ifWrite) syncFile(fileID);
+        readyPages[fileID] = 0;
+        munmap(mapBase[fileID], (size_t) MMAP_RESERVE_PAGES * pageSize);
+        mapBase[fileID] = nullptr;
     }
 
-    void createFile(const char *name) {
+    // 文件当前的页数。
+    int getPageCount(int fileID) {
+        assert(0 <= fileID && fileID < MAX_FILE_NUM && isOpen[fileID]);
+        struct stat st;
+        if (fstat(fileList[fileID], &st) != 0) return 0;
+        return (int) (st.st_size >> pageIdx);
+    }
+
+    // 生成一次整页读写请求。
+    PageRequest request(int fileID, int pageID, char *buf) {
+        assert(0 <= fileID && fileID < MAX_FILE_NUM && isOpen[fileID]);
+        off_t offset = pageID;
+        offset <<= pageIdx;
+        return PageRequest{fileList[fileID], offset, buf, fileID, pageSize};
+    }
+
+    // 批量读写页面，由后端合并提交。
+    void readPages(std::vector<PageRequest> &requests) {
+        if (requests.size() == 0) return;
+        long long start = nanoTime();
+        io->read(requests.data(), requests.size());
+        for (auto &request : requests)
+            if (compressed[request.fileID]) PageCodec::decodePage(request.buf, pageSize);
+        ioNanos += nanoTime() - start;
+        for (auto &request : requests) pagesRead[request.fileID]++;
+    }
+
+    void writePages(std::vector<PageRequest> &requests) {
+        if (requests.size() == 0) return;
+        long long start = nanoTime();
+        std::vector<int> stored;
+        char *encoded = encodeRequests(requests, stored);
+        io->write(requests.data(), requests.size());
+        if (encoded != nullptr) {
+            punchHoles(requests, stored);
+            ::free(encoded);
+        }
+        ioNanos += nanoTime() - start;
+        for (auto &request : requests) pagesWritten[request.fileID]++;
+    }
+
+    // 清零全部读写统计。
+    void resetStats() {
+        for (int i = 0; i < MAX_FILE_NUM; i++) pagesRead[i] = pagesWritten[i] = 0;
+        ioNanos = 0;
+    }
+
+    // 创建文件。压缩文件写入一个压缩形式的空白第 0 页，打开时据此识别。
+    void createFile(const char *name, bool compress = false) {
         FILE *file = fopen(name, "a+");
         assert(file);
+        if (compress) {
+            std::vector<char> page(pageSize, 0), out(pageSize, 0);
+            int len = PageCodec::encodePage(page.data(), pageSize, out.data(), true);
+            assert(len > 0);
+            fwrite(out.data(), 1, pageSize, file);
+        }
         fclose(file);
         permID[name] = nextID++;
     }
 
+    // 逻辑关闭，文件描述符与缓存页面均保留，直到 shutFile 或文件编号被回收。
     void closeFile(int fileID) {
+        assert(isOpen[fileID] && refCount[fileID] > 0);
+        refCount[fileID]--;
+        lastClosed[fileID] = ++closeClock;
+    }
+
+    // 物理关闭。调用前应当先由 BufPageManager 写回或丢弃该文件的缓存页面；映射模式下按 ifWrite 同步或丢弃映射。
+    void shutFile(int fileID, bool ifWrite = true) {
         assert(isOpen[fileID]);
+        unmapFile(fileID, ifWrite);
         isOpen[fileID] = 0;
+        refCount[fileID] = 0;
         int file = fileList[fileID];
         perm2temp.erase(filePermID[fileID]);
+        openedFiles.erase(fileName[fileID]);
         ::close(file);
         idStack[idStackTop++] = fileID;
     }
@@ -92,23 +328,67 @@ public:
     //   }
     // }
 
+    // 若文件已经打开则复用原文件编号。
     int openFile(const char *name) {
+        auto iter = openedFiles.find(name);
+        if (iter != openedFiles.end()) {
+            refCount[iter->second]++;
+            return iter->second;
+        }
         assert(idStackTop);
         int fileID = idStack[--idStackTop];
         isOpen[fileID] = 1;
+        refCount[fileID] = 1;
+        fileName[fileID] = name;
+        openedFiles[name] = fileID;
         filePermID[fileID] = permID[name];
         perm2temp[filePermID[fileID]] = fileID;
-        int file = open(name, O_RDWR);
+        int file = open(name, directMode ? O_RDWR | O_DIRECT : O_RDWR);
+        // 文件系统不支持 O_DIRECT 时（如 tmpfs）退回普通读写
+        if (file == -1 && directMode) file = open(name, O_RDWR);
         assert(file != -1);
         fileList[fileID] = file;
+        // O_DIRECT 要求缓冲区与长度按块对齐
+        char *head = (char*) aligned_alloc(MIN_PAGE_SIZE, MIN_PAGE_SIZE);
+        compressed[fileID] = pread(file, head, MIN_PAGE_SIZE, 0) >= PageCodec::HEADER_SIZE && PageCodec::isEncoded(head);
+        ::free(head);
         return fileID;
     }
 
+    // 返回文件编号，若未打开返回-1。
+    int findFile(const char *name) {
+        auto iter = openedFiles.find(name);
+        return iter == openedFiles.end() ? -1 : iter->second;
+    }
+
+    bool isFull() {
+        return idStackTop == 0;
+    }
+
+    // 返回最早被逻辑关闭且仍未被引用的文件，不存在时返回-1。
+    int getIdleFile() {
+        int ret = -1;
+        for (int i = 0; i < MAX_FILE_NUM; i++) {
+            if (!isOpen[i] || refCount[i] > 0) continue;
+            if (ret == -1 || lastClosed[i] < lastClosed[ret]) ret = i;
+        }
+        return ret;
+    }
+
+    const std::string& getFileName(int fileID) {
+        return fileName[fileID];
+    }
+
     int getFilePermID(int fileID) {
         assert(isOpen[fileID]);
         return filePermID[fileID];
     }
 
+    bool isCompressed(int fileID) {
+        assert(isOpen[fileID]);
+        return compressed[fileID];
+    }
+
     int getFileTempID(int permID) {
         return perm2temp[permID];
     }
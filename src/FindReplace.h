@@ -3,19 +3,57 @@
 
 #include "../util/MultiList.h"
 #include "constants.h"
+#include <deque>
+#include <unordered_set>
 
+// 缓存替换策略。
+enum ReplacePolicy {
+    RP_LRU,
+    RP_2Q
+};
+
+// 缓存替换策略接口。缓存页面按编号管理，被固定的页面不参与替换。
 class FindReplace {
+public:
+    virtual ~FindReplace() {}
+
+    // 页面被释放（写回或丢弃），成为空闲页面。
+    virtual void free(int index) = 0;
+
+    // 命中已缓存的页面。
+    virtual void access(int index) = 0;
+
+    // 页面被 find 选中后载入了新的文件页。
+    virtual void load(int index, int fileID, int pageID) = 0;
+
+    // 固定的页面移出替换队列，不会被选中换出。
+    virtual void pin(int index) = 0;
+
+    virtual void unpin(int index) = 0;
+
+    // 选出一个被替换的页面。
+    virtual int find() = 0;
+
+    /** 创建替换策略。
+     * @param policy 策略种类。
+     * @param capacity 缓存页数。
+     * */
+    static FindReplace *create(ReplacePolicy policy, int capacity);
+};
+
+// 最近最少使用（LRU）策略。
+class LRUReplace : public FindReplace {
 private:
     MultiList *list;
 public:
-    FindReplace() {
-        list = new MultiList(BUF_CAPACITY, 1);
-        for (int i = 0; i < BUF_CAPACITY; i++) {
+    LRUReplace(int capacity) {
+        list = new MultiList(capacity, 1);
+        for (int i = 0; i < capacity; i++) {
             list->insert(0, i);
         }
     }
 
-    ~FindReplace() {
+    ~LRUReplace() {
         delete list;
     }
 
@@ -27,8 +65,19 @@ public:
         list->insert(0, index);
     }
 
+    void load(int, int, int) {}
+
+    void pin(int index) {
+        list->erase(index);
+    }
+
+    void unpin(int index) {
+        list->insert(0, index);
+    }
+
     int find() {
         int index = list->getFirst(0);
+        assert(!list->isHead(index)); // 所有页面均被固定
         list->erase(index);
         list->insert(0, index);
         return index;
@@ -36,4 +85,118 @@ public:
 
 };
 
+/* 2Q 策略（Johnson & Shasha, 1994）。
+ * 新载入的页面进入先进先出队列 A1in，其中的再次访问不提升页面；
+ * 从 A1in 换出的页面只在 A1out 中记录页号。A1out 中的页面再次载入时
+ * 进入 LRU 队列 Am。一次性的全表扫描因此只会占用 A1in，不会冲掉 Am 中的热点页面。
+ */
+class TwoQueueReplace : public FindReplace {
+private:
+    enum Queue {Q_NONE = -1, Q_FREE = 0, Q_A1IN = 1, Q_AM = 2};
+    MultiList *list;
+    int *queue;      // 页面所在队列，固定的页面记录其原队列
+    bool *pinned;
+    long long *keys; // 页面载入的文件页
+    int count[3];
+    int inLimit, outLimit;
+    std::deque<long long> outQueue;
+    std::unordered_set<long long> outSet;
+
+    static long long makeKey(int fileID, int pageID) {
+        return ((long long) fileID << 32) | (unsigned int) pageID;
+    }
+
+    void enqueue(int q, int index) {
+        if (!pinned[index]) list->insert(q, index);
+        if (queue[index] != Q_NONE) count[queue[index]]--;
+        queue[index] = q;
+        count[q]++;
+    }
+
+    void remember(long long key) {
+        if (outSet.count(key)) return;
+        outQueue.push_back(key);
+        outSet.insert(key);
+        while ((int) outQueue.size() > outLimit) {
+            outSet.erase(outQueue.front());
+            outQueue.pop_front();
+        }
+    }
+
+public:
+    TwoQueueReplace(int capacity) {
+        list = new MultiList(capacity, 3);
+        queue = new int[capacity];
+        pinned = new bool[capacity]();
+        keys = new long long[capacity];
+        count[Q_FREE] = count[Q_A1IN] = count[Q_AM] = 0;
+        for (int i = 0; i < capacity; i++) {
+            queue[i] = Q_NONE;
+            keys[i] = -1;
+            enqueue(Q_FREE, i);
+        }
+        inLimit = capacity / 4; if (inLimit < 1) inLimit = 1;
+        outLimit = capacity / 2; if (outLimit < 1) outLimit = 1;
+    }
+
+    ~TwoQueueReplace() {
+        delete list;
+        delete[] queue;
+        delete[] pinned;
+        delete[] keys;
+    }
+
+    void free(int index) {
+        keys[index] = -1;
+        enqueue(Q_FREE, index);
+    }
+
+    void access(int index) {
+        if (queue[index] == Q_AM) list->insert(Q_AM, index);
+    }
+
+    void load(int index, int fileID, int pageID) {
+        long long key = makeKey(fileID, pageID);
+        keys[index] = key;
+        if (outSet.count(key)) {
+            outSet.erase(key);
+            enqueue(Q_AM, index);
+        } else enqueue(Q_A1IN, index);
+    }
+
+    void pin(int index) {
+        pinned[index] = true;
+        list->erase(index);
+    }
+
+    void unpin(int index) {
+        pinned[index] = false;
+        list->insert(queue[index], index);
+    }
+
+    int find() {
+        int index = list->getFirst(Q_FREE);
+        if (list->isHead(index)) {
+            bool fromIn = count[Q_A1IN] > inLimit || list->isHead(list->getFirst(Q_AM));
+            int first = fromIn ? Q_A1IN : Q_AM;
+            index = list->getFirst(first);
+            if (list->isHead(index)) index = list->getFirst(Q_A1IN + Q_AM - first);
+            assert(!list->isHead(index)); // 所有页面均被固定
+            if (queue[index] == Q_A1IN) remember(keys[index]);
+        }
+        // 选中的页面暂留在空闲队列，直到 load 时得知其新的去向
+        keys[index] = -1;
+        enqueue(Q_FREE, index);
+        return index;
+    }
+
+};
+
+inline FindReplace *FindReplace::create(ReplacePolicy policy, int capacity) {
+    switch (policy) {
+        case RP_2Q: return new TwoQueueReplace(capacity);
+        default: return new LRUReplace(capacity);
+    }
+}
+
 #endif
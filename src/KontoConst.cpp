@@ -81,6 +81,7 @@ vector<string> get_index_key_names(string fullFilename) {
 }
 
 void remove_file(string filename) {
+    BufPageManager::getInstance().forgetFile(filename.c_str(), false);
     std::filesystem::path path(filename);
     std::filesystem::remove(path);
 }
@@ -91,6 +92,8 @@ string strip_filename(string filename) {
 }
 
 void rename_file(string old, string newname) {
+    BufPageManager::getInstance().forgetFile(old.c_str(), true);
+    BufPageManager::getInstance().forgetFile(newname.c_str(), false);
     std::filesystem::path path(old);
     std::filesystem::path newpath(newname);
     std::filesystem::rename(path, newpath);
@@ -116,6 +119,7 @@ void create_directory(string str) {
 }
 
 void remove_directory(string str) {
+    BufPageManager::getInstance().forgetDirectory(str);
     std::filesystem::remove_all(str);
 }
 
@@ -49,11 +49,13 @@ enum KontoResult {
     KR_DATA_TOO_LONG            = 0x00000104,
     KR_TYPE_NOT_MATCHING        = 0x00000105,
     KR_NO_SUCH_COLUMN           = 0x00000106,
+    KR_META_FULL                = 0x00000107,
     // ERROR IN KONTOINDEX
     KR_EMPTY_KEYLIST            = 0x00000200,
     KR_NOT_FOUND                = 0x00000201,
     KR_LAST_IPOS                = 0x00000202,
     KR_INDEX_ALREADY_EXISTS     = 0x00000203,
+    KR_KEY_TOO_LONG             = 0x00000204,
     // ERROR IN KONTODBMGR
     KR_NOT_USING_DATABASE       = 0x00000300,
     KR_NO_SUCH_DATABASE         = 0x00000301,
@@ -151,6 +153,8 @@ vector<uint> single_uint_vector(uint num);
 
 // VALUE INTEGER
 inline uint& VI(char* ptr){return *(uint*)(ptr);}
+// VALUE UNSIGNED LONG LONG（位图等按 64 位字访问的数据）
+inline unsigned long long* VULL(char* ptr){return (unsigned long long*)(ptr);}
 // VALUE INTEGER PLUS
 inline uint& VIP(charptr& ptr){ptr+=4; return *(uint*)(ptr-4);}
 // COPY STRING
@@ -39,15 +39,12 @@ const uint POS_PAGE_DATA        = 0x0014;
 
 const uint FLAGS_DELETED        = 0x00000001;
 
-const uint SPLIT_UPPERBOUND     = 8192;
-//const uint SPLIT_UPPERBOUND = 200;
-
 KontoIndex::KontoIndex():
     pmgr(BufPageManager::getInstance()) {}
 
 KontoResult KontoIndex::createIndex(
     string filename, KontoIndex** handle,
-    vector<KontoKeyType> ktypes, vector<uint> kposs, vector<uint> ksizes)
+    vector<KontoKeyType> ktypes, vector<uint> kposs, vector<uint> ksizes, bool compressed)
 {
     if (handle==nullptr) return KR_NULL_PTR;
     if (ktypes.size() == 0) return KR_EMPTY_KEYLIST;
@@ -56,13 +53,12 @@ KontoResult KontoIndex::createIndex(
     ret->keyPositions = kposs;
     ret->keySizes = ksizes;
     string fullFilename = get_filename(filename);
-    ret->pmgr.getFileManager().createFile(fullFilename.c_str());
-    ret->fileID = ret->pmgr.getFileManager().openFile(fullFilename.c_str());
+    ret->pmgr.getFileManager().createFile(fullFilename.c_str(), compressed);
+    ret->fileID = ret->pmgr.openFile(fullFilename.c_str());
     //cout << "INDEX FILEID=" << ret->fileID << endl;
-    int bufindex;
     ret->filename = filename;
-    KontoPage metapage = ret->pmgr.getPage(ret->fileID, 0, bufindex);
-    ret->pmgr.markDirty(bufindex);
+    PageGuard metaGuard(ret->pmgr, ret->fileID, 0), rootGuard(ret->pmgr, ret->fileID, 1);
+    KontoPage metapage = metaGuard.get();
     int n = ret->keyPositions.size();
     VI(metapage + POS_META_KEYCOUNT) = n;
     ret->pageCount = VI(metapage + POS_META_PAGECOUNT) = 2;
@@ -73,13 +69,14 @@ KontoResult KontoIndex::createIndex(
         VI(metapage + POS_META_KEYFIELDS + i * 12 + 8) = ret->keySizes[i];
         ret->indexSize += ret->keySizes[i];
     }
-    KontoPage rootpage = ret->pmgr.getPage(ret->fileID, 1, bufindex);
-    ret->pmgr.markDirty(bufindex);
+    ret->pmgr.markDirty(metaGuard.index());
+    KontoPage rootpage = rootGuard.get();
     VI(rootpage + POS_PAGE_CHILDCOUNT) = 0;
     VI(rootpage + POS_PAGE_NODETYPE) = NODETYPE_LEAF;
     VI(rootpage + POS_PAGE_PREV) = 0;
     VI(rootpage + POS_PAGE_NEXT) = 0;
     VI(rootpage + POS_PAGE_PARENT) = 0;
+    ret->pmgr.markDirty(rootGuard.index());
     if (handle) *handle = ret;
     return KR_OK;
 }
@@ -91,7 +88,7 @@ KontoResult KontoIndex::loadIndex(
     if (handle==nullptr) return KR_NULL_PTR;
     KontoIndex* ret = new KontoIndex();
     string fullFilename = get_filename(filename);
-    ret->fileID = ret->pmgr.getFileManager().openFile(fullFilename.c_str());
+    ret->fileID = ret->pmgr.openFile(fullFilename.c_str());
     int bufindex;
     ret->filename = filename;
     KontoPage metapage = ret->pmgr.getPage(ret->fileID, 0, bufindex);
@@ -124,6 +121,11 @@ string KontoIndex::getIndexFilename(const string database, const vector<string>
     return ret;
 }
 
+bool KontoIndex::keyFits(uint indexSize, int pageSize) {
+    // 叶节点条目较内部节点多8字节；容纳三个条目后仍须放得下第四个才会分裂
+    return POS_PAGE_DATA + 4 * (12 + indexSize) < (uint) pageSize;
+}
+
 int KontoIndex::compare(char* d1, char* d2, KontoKeyType type) {
     if (type == KT_INT) {
         int p1 = *((int*)d1);
@@ -192,13 +194,18 @@ void KontoIndex::setKey(char* dest, char* record, const KontoRPos& pos) {
 }
 
 KontoResult KontoIndex::split(uint pageID) {
+    // 页面内容锁不可重入，父节点在本层页面解锁后再分裂
+    while (pageID != 0) pageID = splitNode(pageID);
+    return KR_OK;
+}
+
+uint KontoIndex::splitNode(uint pageID) {
     //cout << "split: " << pageID << endl;
     // create a new page
-    int oldBufIndex;
-    KontoPage oldPage = pmgr.getPage(fileID, pageID, oldBufIndex);
-    int newBufIndex;
-    KontoPage newPage = pmgr.getPage(fileID, pageCount, newBufIndex);
-    // FIXME: 可能出现无法同时读取两个页面的情况吗
+    // 新旧两页在整个分裂过程中保持固定
+    PageGuard oldGuard(pmgr, fileID, pageID), newGuard(pmgr, fileID, pageCount);
+    KontoPage oldPage = oldGuard.get(), newPage = newGuard.get();
+    int oldBufIndex = oldGuard.index(), newBufIndex = newGuard.index();
     int totalCount = VI(oldPage+POS_PAGE_CHILDCOUNT), splitCount = totalCount / 2;
     // update data in oldpage
     VI(oldPage + POS_PAGE_CHILDCOUNT) = splitCount;
@@ -238,31 +245,33 @@ KontoResult KontoIndex::split(uint pageID) {
             childrenPageID[i] = VI(newPage + POS_PAGE_DATA + i*(4+indexSize));
         int oldPageLastChildrenID = VI(oldPage + POS_PAGE_DATA + (splitCount-1) * (4+indexSize));
         for (int i=0;i<childrenPageCount;i++) {
-            int childBufIndex;
-            KontoPage childPage = pmgr.getPage(fileID, childrenPageID[i], childBufIndex);
-            VI(childPage + POS_PAGE_PARENT) = pageCount;
-            pmgr.markDirty(childBufIndex);
+            PageGuard childGuard(pmgr, fileID, childrenPageID[i]);
+            VI(childGuard.get() + POS_PAGE_PARENT) = pageCount;
+            pmgr.markDirty(childGuard.index());
+        }
+        {
+            PageGuard childGuard(pmgr, fileID, oldPageLastChildrenID);
+            VI(childGuard.get() + POS_PAGE_NEXT) = 0;
+            pmgr.markDirty(childGuard.index());
+        }
+        {
+            PageGuard childGuard(pmgr, fileID, childrenPageID[0]);
+            VI(childGuard.get() + POS_PAGE_PREV) = 0;
+            pmgr.markDirty(childGuard.index());
         }
-        int childBufIndex;
-        KontoPage childPage = pmgr.getPage(fileID, oldPageLastChildrenID, childBufIndex);
-        VI(childPage + POS_PAGE_NEXT) = 0;
-        pmgr.markDirty(childBufIndex);
-        childPage = pmgr.getPage(fileID, childrenPageID[0], childBufIndex);
-        VI(childPage + POS_PAGE_PREV) = 0;
-        pmgr.markDirty(childBufIndex);
         delete[] childrenPageID;
     }
     // update data in nextpage
     if (nextPageID != 0) {
-        int nextBufIndex;
-        KontoPage nextPage = pmgr.getPage(fileID, nextPageID, nextBufIndex);
-        VI(nextPage + POS_PAGE_PREV) = pageCount;
-        pmgr.markDirty(nextBufIndex);
+        PageGuard nextGuard(pmgr, fileID, nextPageID);
+        VI(nextGuard.get() + POS_PAGE_PREV) = pageCount;
+        pmgr.markDirty(nextGuard.index());
     }
     // update data in parentpage
+    uint splitParent = 0;
     if (parentPageID != 0) {
-        int parentBufIndex;
-        KontoPage parentPage = pmgr.getPage(fileID, parentPageID, parentBufIndex);
+        PageGuard parentGuard(pmgr, fileID, parentPageID);
+        KontoPage parentPage = parentGuard.get();
         // find the pageid
         assert(VI(parentPage + POS_PAGE_NODETYPE) == NODETYPE_INNER);
         int i = 0; 
@@ -282,49 +291,47 @@ KontoResult KontoIndex::split(uint pageID) {
             indexSize);
         VI(parentPage + POS_PAGE_DATA + (i+1)*(4+indexSize)) = pageCount;
         VI(parentPage + POS_PAGE_CHILDCOUNT) ++;
-        pmgr.markDirty(parentBufIndex);
+        pmgr.markDirty(parentGuard.index());
         pageCount ++; 
-        if (POS_PAGE_DATA + (VI(parentPage + POS_PAGE_CHILDCOUNT)+1) * (4+indexSize) >= SPLIT_UPPERBOUND) {
+        if (POS_PAGE_DATA + (VI(parentPage + POS_PAGE_CHILDCOUNT)+1) * (4+indexSize) >= (uint) pmgr.getPageSize()) {
             //cout << "before split: page " << parentPageID << " has " << childCount+1 
             //    << " children " << endl;
-            split(parentPageID);
+            splitParent = parentPageID;
         }
     } else {
-        // reload old page, transfer to another new page
-        oldPage = pmgr.getPage(fileID, pageID, oldBufIndex);
+        // transfer old page to another new page
         char* oldPageKey = new char[indexSize];
         if (VI(oldPage + POS_PAGE_NODETYPE) == NODETYPE_INNER)
             memcpy(oldPageKey, oldPage + POS_PAGE_DATA + 4, indexSize);
         else    
             memcpy(oldPageKey, oldPage + POS_PAGE_DATA + 12, indexSize);
-        int anotherBufIndex;
         // anotherPageID = pageCount + 1;
-        KontoPage anotherPage = pmgr.getPage(fileID, pageCount + 1, anotherBufIndex);
-        memcpy(anotherPage, oldPage, PAGE_SIZE);
+        PageGuard anotherGuard(pmgr, fileID, pageCount + 1);
+        KontoPage anotherPage = anotherGuard.get();
+        memcpy(anotherPage, oldPage, pmgr.getPageSize());
         VI(anotherPage + POS_PAGE_PARENT) = 1;
-        pmgr.markDirty(anotherBufIndex);
+        pmgr.markDirty(anotherGuard.index());
         if (VI(anotherPage + POS_PAGE_NODETYPE) == NODETYPE_INNER) {
             int childrenPageCount = VI(anotherPage + POS_PAGE_CHILDCOUNT);
             uint* childrenPageID = new uint[childrenPageCount];
             for (int i=0;i<childrenPageCount;i++) 
                 childrenPageID[i] = VI(anotherPage + POS_PAGE_DATA + i*(4+indexSize));
             for (int i=0;i<childrenPageCount;i++) {
-                int childBufIndex;
-                KontoPage childPage = pmgr.getPage(fileID, childrenPageID[i], childBufIndex);
-                VI(childPage + POS_PAGE_PARENT) = pageCount + 1;
-                pmgr.markDirty(childBufIndex);
+                PageGuard childGuard(pmgr, fileID, childrenPageID[i]);
+                VI(childGuard.get() + POS_PAGE_PARENT) = pageCount + 1;
+                pmgr.markDirty(childGuard.index());
             }
             delete[] childrenPageID;
         }
         //cout << "split: copied to another page." << endl;
-        newPage = pmgr.getPage(fileID, pageCount, newBufIndex);
         VI(newPage + POS_PAGE_PREV) = pageCount + 1;
         VI(newPage + POS_PAGE_PARENT) = 1;
         pmgr.markDirty(newBufIndex);
         //cout << "split: connected new page." << endl;
         // refresh root page
-        int rootBufIndex;
-        KontoPage rootPage = pmgr.getPage(fileID, 1, rootBufIndex);
+        // 没有父节点的即是根节点，根页面就是已经锁住的旧页面
+        assert(pageID == 1);
+        KontoPage rootPage = oldPage;
         VI(rootPage + POS_PAGE_CHILDCOUNT) = 2;
         VI(rootPage + POS_PAGE_NODETYPE) = NODETYPE_INNER;
         VI(rootPage + POS_PAGE_PREV) = VI(rootPage + POS_PAGE_NEXT) = 0;
@@ -333,20 +340,19 @@ KontoResult KontoIndex::split(uint pageID) {
         memcpy(rootPage + POS_PAGE_DATA + 4, oldPageKey, indexSize);
         VI(rootPage + POS_PAGE_DATA + 4 + indexSize) = pageCount;
         memcpy(rootPage + POS_PAGE_DATA + 4 + indexSize + 4, newPageKey, indexSize);
-        pmgr.markDirty(rootBufIndex);
+        pmgr.markDirty(oldBufIndex);
         delete[] oldPageKey;
         pageCount += 2;
         //cout << "split: connected root page." << endl;
     }
     // refresh meta page for pagecount
-    int metaBufIndex;
-    KontoPage metaPage = pmgr.getPage(fileID, 0, metaBufIndex);
-    VI(metaPage + POS_META_PAGECOUNT) = pageCount;
-    pmgr.markDirty(metaBufIndex);
+    PageGuard metaGuard(pmgr, fileID, 0);
+    VI(metaGuard.get() + POS_META_PAGECOUNT) = pageCount;
+    pmgr.markDirty(metaGuard.index());
     delete[] newPageKey;
     //cout << "split: finished." << endl;
     //debugPrint();
-    return KR_OK;
+    return splitParent;
 }
 
 void KontoIndex::debugPageOne() {
@@ -367,7 +373,11 @@ KontoResult KontoIndex::insertRecur(char* record, const KontoRPos& pos, uint pag
     uint childcount = VI(page + POS_PAGE_CHILDCOUNT);
     //cout << "got nodetype=" << nodetype << ", childcount=" << childcount << endl;
     assert(nodetype == NODETYPE_INNER || nodetype == NODETYPE_LEAF);
+    // 叶节点写满时在页面解锁后分裂
+    bool full = false;
     if (nodetype == NODETYPE_LEAF) {
+        PageGuard guard(pmgr, fileID, pageID);
+        page = guard.get();
         int iter = 0;
         //cout << "before iteration" << endl;
         while (true) {
@@ -387,11 +397,11 @@ KontoResult KontoIndex::insertRecur(char* record, const KontoRPos& pos, uint pag
         //cout << "aft"; debugPageOne();
         //cout << "childcount = " << childcount << endl;
         VI(page + POS_PAGE_CHILDCOUNT) = ++childcount;
-        pmgr.markDirty(bufindex);
-        if (POS_PAGE_DATA + (childcount+1) * (12+indexSize) >= SPLIT_UPPERBOUND) { 
+        pmgr.markDirty(guard.index());
+        if (POS_PAGE_DATA + (childcount+1) * (12+indexSize) >= (uint) pmgr.getPageSize()) { 
             //cout << "before split: page " << pageID << " has " << childcount
             //    << " children. indexsize = " << indexSize << endl; 
-            split(pageID);
+            full = true;
         }
         //cout << "wrt"; debugPageOne();
     } else {
@@ -406,6 +416,7 @@ KontoResult KontoIndex::insertRecur(char* record, const KontoRPos& pos, uint pag
         //cout << "iter = " << iter << " before recur" << endl;
         insertRecur(record, pos, VI(page + POS_PAGE_DATA + iter * (4+indexSize)));
     }
+    if (full) split(pageID);
     return KR_OK;
 }
 
@@ -443,7 +454,8 @@ KontoResult KontoIndex::queryIposRecur(char* record, KontoIPos& out, uint pageID
             else if (!equal && compareResult <= 0) break;
             iter++;
         }
-        iter--; if (iter<0) return KR_NOT_FOUND;
+        // 比最小键更小的记录插入在第一个子节点中而不更新分隔键，因此这里同样进入第一个子节点
+        iter--; if (iter<0) iter = 0;
         return queryIposRecur(record, out, VI(page + POS_PAGE_DATA + iter * (4+indexSize)), equal);
     }
     return KR_NOT_FOUND;
@@ -521,10 +533,9 @@ KontoResult KontoIndex::remove(char* record, const KontoRPos& pos) {
         qres = getPrevious(query);
         if (qres == KR_NOT_FOUND) return KR_NOT_FOUND;
     }
-    int pageBufIndex;
-    KontoPage page = pmgr.getPage(fileID, query.page, pageBufIndex);
-    VI(page + POS_PAGE_DATA + (12+indexSize) * query.id + 8) |= FLAGS_DELETED;
-    pmgr.markDirty(pageBufIndex);
+    PageGuard guard(pmgr, fileID, query.page);
+    VI(guard.get() + POS_PAGE_DATA + (12+indexSize) * query.id + 8) |= FLAGS_DELETED;
+    pmgr.markDirty(guard.index());
     return KR_OK;
 }
 
@@ -661,7 +672,6 @@ KontoResult KontoIndex::getPrevious(KontoIPos& pos) {
 }
 
 KontoResult KontoIndex::close() {
-    pmgr.closeFile(fileID);
     pmgr.getFileManager().closeFile(fileID);
     return KR_OK;
 }
@@ -735,15 +745,15 @@ void KontoIndex::debugPrint() {
 }
 
 void KontoIndex::debugPrintPage(int pageID, bool recur) {
-    int pageBufIndex;
-    KontoPage page = pmgr.getPage(fileID, pageID, pageBufIndex);
+    PageGuard guard(pmgr, fileID, pageID, false);
+    KontoPage page = guard.get();
     printf("-----[PageId: %d]-----\n", pageID);
     printf("NodeType = %d\n", VI(page + POS_PAGE_NODETYPE));
     printf("ChildCount = %d\n", VI(page + POS_PAGE_CHILDCOUNT));
     printf("PrevBroPage = %d, NextBroPage = %d\n", VI(page + POS_PAGE_PREV), VI(page + POS_PAGE_NEXT));
     printf("ParentPage = %d\n", VI(page + POS_PAGE_PARENT));
     int cnt = VI(page + POS_PAGE_CHILDCOUNT);
-    assert(cnt<PAGE_SIZE);
+    assert(cnt<pmgr.getPageSize());
     int type = VI(page + POS_PAGE_NODETYPE);
     for (int i=0;i<cnt;i++) {
         if (type==NODETYPE_INNER) {
@@ -771,12 +781,13 @@ void KontoIndex::debugPrintPage(int pageID, bool recur) {
 } 
 
 KontoResult KontoIndex::recreate(KontoIndex* original, KontoIndex** handle) {
+    bool compressed = original->isCompressed();
     original->close();
     string filename = original->filename;
     string fullFilename = get_filename(original->filename);
     remove_file(fullFilename);
     createIndex(filename, handle, original->keyTypes, 
-        original->keyPositions, original->keySizes);
+        original->keyPositions, original->keySizes, compressed);
     return KR_OK;
 }
 
@@ -798,9 +809,10 @@ KontoResult KontoIndex::queryInterval(char* lower, char* upper, KontoQRes& out,
     KontoResult result;
     if (lower) {
         result = queryIpos(lower, lowerIpos, !lowerIncluded);
-        if (result == KR_NOT_FOUND) 
+        if (result == KR_NOT_FOUND) {
             result = queryIposFirst(lowerIpos);
-        else {
+            if (result == KR_NOT_FOUND) {out = KontoQRes();return KR_OK;}
+        } else {
             KontoIPos lowerNext; 
             result = getNext(lowerIpos, lowerNext);
             if (result == KR_NOT_FOUND) {out = KontoQRes();return KR_OK;}
@@ -814,6 +826,11 @@ KontoResult KontoIndex::queryInterval(char* lower, char* upper, KontoQRes& out,
     if (upper) {
         result = queryIpos(upper, upperIpos, upperIncluded);
         if (result == KR_NOT_FOUND) {out = KontoQRes();return KR_OK;}
+        // 区间内没有键时 lowerIpos 位于 upperIpos 之后，下面的遍历将无法停止
+        int bufindex;
+        KontoPage page = pmgr.getPage(fileID, lowerIpos.page, bufindex);
+        int comp = compare(upper, page + POS_PAGE_DATA + lowerIpos.id * (12+indexSize) + 12);
+        if (comp < 0 || (comp == 0 && !upperIncluded)) {out = KontoQRes();return KR_OK;}
     } else {
         result = queryIposLast(upperIpos);
         if (result == KR_NOT_FOUND) {out = KontoQRes();return KR_OK;}
@@ -834,11 +851,14 @@ KontoResult KontoIndex::queryInterval(char* lower, char* upper, KontoQRes& out,
 
 string KontoIndex::getFilename() {return filename;}
 
+bool KontoIndex::isCompressed() {return pmgr.getFileManager().isCompressed(fileID);}
+
+int KontoIndex::getPageCount() {return pageCount;}
+
 void KontoIndex::renameTable(string newname) {
     int pos = filename.find(".");
     string newIndexFilename = newname + filename.substr(pos, filename.length()-pos);
-    pmgr.closeFile(fileID);
     rename_file(get_filename(filename), get_filename(newIndexFilename));
-    fileID = pmgr.getFileManager().openFile(get_filename(newIndexFilename).c_str());
+    fileID = pmgr.openFile(get_filename(newIndexFilename).c_str());
     filename = newIndexFilename;
 }
\ No newline at end of file
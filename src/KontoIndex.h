@@ -61,6 +61,11 @@ private:
      * @param pageID 要分裂的页编号。
      * */
     KontoResult split(uint pageID);
+    /** 分裂单个节点，分裂期间锁住涉及的页面
+     * @param pageID 要分裂的页编号。
+     * @return 随之需要分裂的父节点页编号，不需要时为0。
+     * */
+    uint splitNode(uint pageID);
     /** 递归查询
      * @param record 要查询的记录数据
      * @param out 查到的结果输出
@@ -132,9 +137,10 @@ public:
      * @param ktypes 索引键各列类型。
      * @param kposs 各列在原表中的存储位置对应数据起始处指针的偏移量。
      * @param ksizes 各列所占空间大小，以字节为单位。
+     * @param compressed 是否压缩存储。
      * */
     static KontoResult createIndex(string filename, KontoIndex** handle, 
-        vector<KontoKeyType> ktypes, vector<uint> kposs, vector<uint> ksizes);
+        vector<KontoKeyType> ktypes, vector<uint> kposs, vector<uint> ksizes, bool compressed = false);
     /** 加载索引
      * @param filename 文件名。
      * @param handle 成功读取后结果通过handle返回。
@@ -145,6 +151,12 @@ public:
      * @param keyNames 索引键各列名。
      * */
     static string getIndexFilename(const string database, const vector<string> keyNames); 
+    /** 检查键长是否使每个节点在分裂前至少容纳三个条目。
+     * 否则分裂后的节点与其父节点无法保持B+树的结构，页面越小越容易触及此限制。
+     * @param indexSize 索引键各列大小之和。
+     * @param pageSize 页大小。
+     * */
+    static bool keyFits(uint indexSize, int pageSize);
     /** 插入一条记录
      * @param record 数据。
      * @param pos 数据在数据表中的位置。
@@ -186,6 +198,10 @@ public:
     static KontoResult recreate(KontoIndex* original, KontoIndex** handle);
     // 返回文件名。
     string getFilename();
+    // 索引文件是否压缩存储。
+    bool isCompressed();
+    // 返回索引文件的页数。
+    int getPageCount();
     // 删除索引。
     KontoResult drop();
     /** 等值查询。
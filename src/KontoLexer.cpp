@@ -92,6 +92,15 @@ std::ostream& operator <<(std::ostream& stream, const Token& t){
         case TK_ECHO: stream << "Echo"; break;
         case TK_TABLES: stream << "Tables"; break;
         case TK_TO: stream << "To"; break;
+        case TK_CHECKPOINT: stream << "Checkpoint"; break;
+        case TK_BUFFER: stream << "Buffer"; break;
+        case TK_STATS: stream << "Stats"; break;
+        case TK_RESET: stream << "Reset"; break;
+        case TK_COMPRESSED: stream << "Compressed"; break;
+        case TK_PAGESIZE: stream << "Pagesize"; break;
+        case TK_VACUUM: stream << "Vacuum"; break;
+        case TK_PAX: stream << "Pax"; break;
+        case TK_SLOTTED: stream << "Slotted"; break;
         default: stream << "Unknown token type"; break;
     }
     stream << "]";
@@ -446,6 +455,15 @@ void KontoLexer::addDefaultKeywords(){
     addKeyword("to", TK_TO);
     addKeyword("on", TK_ON);
     addKeyword("off", TK_OFF);
+    addKeyword("checkpoint", TK_CHECKPOINT);
+    addKeyword("buffer", TK_BUFFER);
+    addKeyword("stats", TK_STATS);
+    addKeyword("reset", TK_RESET);
+    addKeyword("compressed", TK_COMPRESSED);
+    addKeyword("pagesize", TK_PAGESIZE);
+    addKeyword("vacuum", TK_VACUUM);
+    addKeyword("pax", TK_PAX);
+    addKeyword("slotted", TK_SLOTTED);
 }
 
 void KontoLexer::putback(Token token) {
@@ -41,6 +41,8 @@ enum TokenKind {
     TK_REFERENCES, TK_QUIT, TK_DEBUG, TK_ECHO, TK_TABLES, TK_TO,
     TK_OFF,
     TK_ON,
+    TK_CHECKPOINT,
+    TK_BUFFER, TK_STATS, TK_RESET, TK_COMPRESSED, TK_PAGESIZE, TK_VACUUM, TK_PAX, TK_SLOTTED,
     // symbols
     TK_LPAREN, TK_RPAREN, TK_LBRACE, TK_RBRACE, TK_SEMICOLON, 
     TK_COMMA, 
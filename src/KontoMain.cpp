@@ -11,7 +11,40 @@ KontoTerminal* terminal;
 
 int main(int argc, const char* argv[]){
     bool flag = true;
-    if (argc>1 && (strcmp(argv[1], "-F"))==0) flag = false;
+    int bufferPages = BUF_CAPACITY; bool hugePage = false;
+    ReplacePolicy policy = RP_LRU; int highWater = -1; bool uring = true;
+    int readAhead = READAHEAD_PAGES; bool mapped = false; bool direct = false;
+    int checkpoint = 0; int shards = 0;
+    // -F 从文件读入；-B [pages] 缓存页数；-H 使用大页作为缓存；-R [lru|2q] 缓存替换策略；
+    // -W [pages] 脏页上限，超过后由后台线程写回，默认为缓存页数的 1/4，0 表示不使用后台线程；-I [uring|sync] 批量读写后端；
+    // -A [pages] 顺序预读页数，0 表示不预读；-M 映射模式，页面直接访问文件映射区；
+    // -D 以 O_DIRECT 读写文件；-C [seconds] 周期检查点间隔，0 表示不做周期检查点；
+    // -S [count] 缓存分片数，0 表示自动选取
+    for (int i=1;i<argc;i++) {
+        if (strcmp(argv[i], "-F")==0) flag = false;
+        else if (strcmp(argv[i], "-H")==0) hugePage = true;
+        else if (strcmp(argv[i], "-M")==0) mapped = true;
+        else if (strcmp(argv[i], "-D")==0) direct = true;
+        else if (strcmp(argv[i], "-B")==0 && i+1<argc) bufferPages = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-W")==0 && i+1<argc) highWater = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-I")==0 && i+1<argc) uring = strcmp(argv[++i], "sync")!=0;
+        else if (strcmp(argv[i], "-A")==0 && i+1<argc) readAhead = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-C")==0 && i+1<argc) checkpoint = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-S")==0 && i+1<argc) shards = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-R")==0 && i+1<argc) {
+            i++;
+            if (strcmp(argv[i], "2q")==0) policy = RP_2Q;
+            else if (strcmp(argv[i], "lru")==0) policy = RP_LRU;
+            else cout << "Unknown replace policy " << argv[i] << ", using lru." << endl;
+        }
+    }
+    if (bufferPages < 16) bufferPages = 16;
+    BufPageManager::configure(bufferPages, hugePage, policy, highWater, uring);
+    BufPageManager::configureReadAhead(readAhead);
+    BufPageManager::configureMapped(mapped);
+    BufPageManager::configureDirect(direct);
+    BufPageManager::configureCheckpoint(checkpoint);
+    BufPageManager::configureShards(shards);
     terminal = KontoTerminal::getInstance();
     terminal->main(flag);
     return 0;
@@ -16,6 +16,10 @@
     每条记录的长度
     域的个数
     当前最后一页已有的条目数
+    空闲槽链表的表头（槽号加一，0表示链表为空）
+    数据页是否带有页头（旧格式的表为0）
+    数据页是否采用PAX布局
+    数据页是否为变长记录的槽页
   * 2560开始，
     主键域的个数（若无主键置零）
     各个主键的编号
@@ -23,7 +27,18 @@
     * 外键个数
       * 每个外键的列数，以及对应哪些列，fkname, foreigntablename, foreignnames
 * 之后每页存储信息，按照每条记录长度存储
+  * 每页以页头开始：存活记录数，保留的一个uint，之后是删除位图，每64个槽一个uint64，
+    位为1表示该槽的记录已删除。页头之后依次存放记录。扫描时跳过存活记录数为0的页，
+    其余页按位图逐位取出存活的槽
+  * PAX布局的表在页头之后按列分组：依次为各槽的rid、控制位与各列数据，每列占一段连续空间，
+    只读取某一列时不必经过整行
+  * 变长记录的表使用槽页：页头为存活记录数、槽数、记录区起点、记录区中的废弃字节数，
+    之后是槽数组，每个槽记录一条记录在页中的偏移与长度。记录从页尾向前存放，
+    字符串列只存到结尾的0为止。删除的记录在整理页面时只保留rid与控制位；
+    记录变长放不下时先整理本页，仍放不下则移到其他页
   * 每条记录，0为记录编号rid，1为控制位（二进制最低位表示是否已删除），之后开始为数据
+  * 已删除的记录串成空闲槽链表，其rid处存放链表中下一个槽的槽号加一。
+    槽号为 (页号-1)*每页记录数+页内编号。插入时优先复用链表头的槽，链表为空时才追加到最后一页
 */
 
 const uint POS_FILENAME          = 0x00000000;
@@ -34,13 +49,34 @@ const uint POS_META_EXISTCOUNT   = 0x00000808;
 const uint POS_META_RECORDSIZE   = 0x0000080c;
 const uint POS_META_FIELDCOUNT   = 0x00000810;
 const uint POS_META_LASTPAGE     = 0x00000814;
+const uint POS_META_FREESLOT     = 0x00000818;
+const uint POS_META_PAGEHEADER   = 0x0000081c;
+const uint POS_META_PAX          = 0x00000820;
+const uint POS_META_SLOTTED      = 0x00000824;
 const uint POS_META_PRIMARYCOUNT = 0x00000a00;
 const uint POS_META_PRIMARIES    = 0x00000a04;
 const uint POS_META_FOREIGNS     = 0x00000c00;
 
+const uint POS_PAGE_LIVECOUNT    = 0x00000000;
+const uint POS_PAGE_BITMAP       = 0x00000008;
+const uint POS_PAGE_SLOTCOUNT    = 0x00000004;
+const uint POS_PAGE_HEAPSTART    = 0x00000008;
+const uint POS_PAGE_GARBAGE      = 0x0000000c;
+const uint POS_PAGE_SLOTS        = 0x00000010;
+
 const uint FLAGS_DELETED         = 0x00000001;
 const uint FIELD_FLAGS_NULLABLE  = 0x00000001;
 
+// 删除后整理过的记录只剩rid与控制位，读取其数据列时指向此处的零。
+static char emptyRecord[MAX_PAGE_SIZE];
+
+// 变长记录中一列所占的字节数：字符串只存到结尾的0为止，其余列定长。
+static int storedSize(const KontoCDef& key, const char* ptr) {
+    if (key.type != KT_STRING) return key.size;
+    int len = strnlen(ptr, key.size);
+    return len < (int) key.size ? len + 1 : len;
+}
+
 KontoTableFile::KontoTableFile() : pmgr(BufPageManager::getInstance()) {
     fieldDefined = false;
     keys = vector<KontoColumnDefinition>();
@@ -50,15 +86,18 @@ KontoTableFile::~KontoTableFile() {}
 
 KontoResult KontoTableFile::createFile(
         string filename, 
-        KontoTableFile** handle) {
+        KontoTableFile** handle,
+        bool compressed,
+        bool pax,
+        bool slotted) {
     if (handle==nullptr) return KR_NULL_PTR;
     string fullFilename = get_filename(filename);
     KontoTableFile* ret = new KontoTableFile();
-    ret->pmgr.getFileManager().createFile(fullFilename.c_str());
-    ret->fileID = ret->pmgr.getFileManager().openFile(fullFilename.c_str());
-    int bufindex;
+    ret->pmgr.getFileManager().createFile(fullFilename.c_str(), compressed);
+    ret->fileID = ret->pmgr.openFile(fullFilename.c_str());
     ret->filename = filename;
-    KontoPage metapage = ret->pmgr.getPage(ret->fileID, 0, bufindex);
+    PageGuard guard(ret->pmgr, ret->fileID, 0);
+    KontoPage metapage = guard.get();
     strcpy(metapage+POS_FILENAME, filename.c_str());
     ret->pageCount = VI(metapage + POS_META_PAGECOUNT) = 2;
     ret->recordCount = VI(metapage + POS_META_RECORDCOUNT) = 0;
@@ -68,7 +107,17 @@ KontoResult KontoTableFile::createFile(
     VI(metapage + POS_META_PRIMARYCOUNT) = 0;
     VI(metapage + POS_META_FOREIGNS) = 0;
     VI(metapage + POS_META_LASTPAGE) = 0;
-    ret->pmgr.markDirty(bufindex);
+    VI(metapage + POS_META_FREESLOT) = 0;
+    VI(metapage + POS_META_PAGEHEADER) = 1;
+    VI(metapage + POS_META_PAX) = pax;
+    VI(metapage + POS_META_SLOTTED) = slotted;
+    ret->pageHeader = true;
+    ret->pax = pax;
+    ret->slotted = slotted;
+    ret->updateLayout();
+    ret->pmgr.markDirty(guard.index());
+    ret->loadMeta();
+    ret->clearPage(1);
     ret->removeIndices();
     *handle = ret;
     return KR_OK;
@@ -81,13 +130,11 @@ KontoResult KontoTableFile::loadFile(
     KontoTableFile* ret = new KontoTableFile();
     ret->filename = filename;
     string fullFilename = get_filename(filename);
-    ret->fileID = ret->pmgr.getFileManager().openFile(fullFilename.c_str());
+    ret->fileID = ret->pmgr.openFile(fullFilename.c_str());
     int bufindex;
     ret->filename = filename;
     KontoPage metapage = ret->pmgr.getPage(ret->fileID, 0, bufindex);
     ret->fieldDefined = true;
-    ret->recordCount = VI(metapage + POS_META_RECORDCOUNT);
-    ret->pageCount = VI(metapage + POS_META_PAGECOUNT);
     ret->recordSize = VI(metapage + POS_META_RECORDSIZE);
     char* ptr = metapage + POS_FIELDS;
     int fc = VI(metapage + POS_META_FIELDCOUNT);
@@ -107,6 +154,11 @@ KontoResult KontoTableFile::loadFile(
         pos += col.size;
     }
     ret->recordSize = pos;
+    ret->pageHeader = VI(metapage + POS_META_PAGEHEADER) != 0;
+    ret->pax = VI(metapage + POS_META_PAX) != 0;
+    ret->slotted = VI(metapage + POS_META_SLOTTED) != 0;
+    ret->updateLayout();
+    ret->loadMeta();
     ret->loadIndices();
     *handle = ret;
     return KR_OK;
@@ -115,8 +167,8 @@ KontoResult KontoTableFile::loadFile(
 KontoResult KontoTableFile::defineField(KontoCDef& def) {
     if (fieldDefined) return KR_FIELD_ALREARY_DEFINED;
     // 添加到元数据页
-    int bufindex;
-    KontoPage metapage = pmgr.getPage(fileID, 0, bufindex);
+    PageGuard guard(pmgr, fileID, 0);
+    KontoPage metapage = guard.get();
     char* ptr = metapage + POS_FIELDS;
     //char* originalptr = ptr;
     int fc = VI(metapage + POS_META_FIELDCOUNT);
@@ -149,8 +201,9 @@ KontoResult KontoTableFile::defineField(KontoCDef& def) {
     recordSize += def.size;
     VI(metapage + POS_META_RECORDSIZE) = recordSize;
     VI(metapage + POS_META_FIELDCOUNT)++;
+    updateLayout();
     keys.push_back(def);
-    pmgr.markDirty(bufindex);
+    pmgr.markDirty(guard.index());
     return KR_OK;
 }
 
@@ -160,8 +213,57 @@ KontoResult KontoTableFile::finishDefineField(){
     return KR_OK;
 }
 
+void KontoTableFile::loadMeta() {
+    int bufindex;
+    KontoPage metapage = pmgr.getPage(fileID, 0, bufindex);
+    pageCount = VI(metapage + POS_META_PAGECOUNT);
+    recordCount = VI(metapage + POS_META_RECORDCOUNT);
+    existCount = VI(metapage + POS_META_EXISTCOUNT);
+    lastPageCount = VI(metapage + POS_META_LASTPAGE);
+    freeSlot = VI(metapage + POS_META_FREESLOT);
+    metaDirty = false;
+    loadConstraints();
+}
+
+void KontoTableFile::loadConstraints() {
+    int bufindex;
+    KontoPage metapage = pmgr.getPage(fileID, 0, bufindex);
+    char* ptr = metapage + POS_META_PRIMARYCOUNT;
+    int n = VIP(ptr);
+    primaryKeys.clear();
+    while (n--) primaryKeys.push_back(VIP(ptr));
+    ptr = metapage + POS_META_FOREIGNS;
+    n = VIP(ptr);
+    foreignKeys.clear();
+    while (n--) {
+        KontoForeignKey fk;
+        int c = VIP(ptr);
+        for (int i=0;i<c;i++) fk.cols.push_back(VIP(ptr));
+        CS(fk.name, ptr);
+        CS(fk.table, ptr);
+        for (int i=0;i<c;i++) {
+            string buf; CS(buf, ptr);
+            fk.foreignNames.push_back(buf);
+        }
+        foreignKeys.push_back(fk);
+    }
+}
+
+void KontoTableFile::flushMeta() {
+    if (!metaDirty) return;
+    PageGuard guard(pmgr, fileID, 0);
+    KontoPage metapage = guard.get();
+    VI(metapage + POS_META_PAGECOUNT) = pageCount;
+    VI(metapage + POS_META_RECORDCOUNT) = recordCount;
+    VI(metapage + POS_META_EXISTCOUNT) = existCount;
+    VI(metapage + POS_META_LASTPAGE) = lastPageCount;
+    VI(metapage + POS_META_FREESLOT) = freeSlot;
+    pmgr.markDirty(guard.index());
+    metaDirty = false;
+}
+
 KontoResult KontoTableFile::close() {
-    pmgr.closeFile(fileID);
+    flushMeta();
     pmgr.getFileManager().closeFile(fileID);
     for (auto indexPtr : indices) {
         indexPtr->close();
@@ -170,55 +272,279 @@ KontoResult KontoTableFile::close() {
 }
 
 KontoResult KontoTableFile::insertEntry(KontoRPos* pos) {
-    int metapid;
-    KontoPage meta = pmgr.getPage(fileID, 0, metapid);
+    assert(!slotted);
     KontoRPos rec;
-    bool found = (1 + VI(meta + POS_META_LASTPAGE)) * recordSize <= PAGE_SIZE;
-    if (!found) {
-        VI(meta + POS_META_PAGECOUNT) = ++pageCount;
+    if (freeSlot != 0) {
+        rec = getSlotPosition(freeSlot - 1);
+        int slotpid;
+        KontoPage slot = pmgr.getPage(fileID, rec.page, slotpid);
+        freeSlot = VI(getFieldPointer(slot, rec.id, 0, 4));
+    } else if (lastPageCount >= (uint) slotCount) {
+        ++pageCount;
+        clearPage(pageCount-1);
         rec = KontoRPos(pageCount-1, 0);
-        VI(meta + POS_META_LASTPAGE) = 1;
+        lastPageCount = 1;
     } else {
-        rec = KontoRPos(pageCount-1, VI(meta+POS_META_LASTPAGE));
-        VI(meta+POS_META_LASTPAGE)++;
-    }
-    VI(meta + POS_META_RECORDCOUNT) = ++recordCount;
-    VI(meta + POS_META_EXISTCOUNT)++;
-    pmgr.markDirty(metapid);
-    int wrpid; 
-    KontoPage wr = pmgr.getPage(fileID, rec.page, wrpid);
-    char* ptr = wr + rec.id * recordSize;
-    VIP(ptr) = recordCount;
-    VIP(ptr) = 0;
-    pmgr.markDirty(wrpid);
+        rec = KontoRPos(pageCount-1, lastPageCount++);
+    }
+    ++recordCount; ++existCount;
+    metaDirty = true;
+    PageGuard guard(pmgr, fileID, rec.page);
+    KontoPage wr = guard.get();
+    VI(getFieldPointer(wr, rec.id, 0, 4)) = recordCount;
+    VI(getFieldPointer(wr, rec.id, 4, 4)) = 0;
+    if (pageHeader) {
+        VI(wr + POS_PAGE_LIVECOUNT)++;
+        VULL(wr + POS_PAGE_BITMAP)[rec.id / 64] &= ~(1ULL << (rec.id % 64));
+    }
+    pmgr.markDirty(guard.index());
     if (pos) *pos=rec;
     return KR_OK;
 }
 
 KontoResult KontoTableFile::deleteEntry(const KontoRPos& pos) {
-    int metapid;
-    KontoPage meta = pmgr.getPage(fileID, 0, metapid);
-    int wrpid;
-    KontoPage wr = pmgr.getPage(fileID, pos.page, wrpid);
-    char* ptr = wr + pos.id * recordSize;
-    VI(ptr + 4) |= FLAGS_DELETED;
-    pmgr.markDirty(wrpid);
+    if (slotted) {
+        PageGuard guard(pmgr, fileID, pos.page);
+        KontoPage wr = guard.get();
+        char* slot = wr + POS_PAGE_SLOTS + pos.id * 8;
+        uint& flags = VI(wr + VI(slot) + 4);
+        if (flags & FLAGS_DELETED) return KR_OK;
+        flags |= FLAGS_DELETED;
+        VI(wr + POS_PAGE_LIVECOUNT)--;
+        VI(wr + POS_PAGE_GARBAGE) += VI(slot + 4) - 8;
+        pmgr.markDirty(guard.index());
+        --existCount;
+        metaDirty = true;
+        return KR_OK;
+    }
+    PageGuard guard(pmgr, fileID, pos.page);
+    KontoPage wr = guard.get();
+    uint& flags = VI(getFieldPointer(wr, pos.id, 4, 4));
+    if (flags & FLAGS_DELETED) return KR_OK;
+    flags |= FLAGS_DELETED;
+    if (pageHeader) {
+        VI(wr + POS_PAGE_LIVECOUNT)--;
+        VULL(wr + POS_PAGE_BITMAP)[pos.id / 64] |= 1ULL << (pos.id % 64);
+    }
+    VI(getFieldPointer(wr, pos.id, 0, 4)) = freeSlot;
+    pmgr.markDirty(guard.index());
+    freeSlot = getSlotNumber(pos) + 1;
+    --existCount;
+    metaDirty = true;
     return KR_OK;
 }
 
-char* KontoTableFile::getDataPointer(const KontoRPos& pos, KontoKeyIndex key, bool write = false){
+uint KontoTableFile::getSlotNumber(const KontoRPos& pos) {
+    return (pos.page - 1) * slotCount + pos.id;
+}
+
+KontoRPos KontoTableFile::getSlotPosition(uint slot) {
+    return KontoRPos(slot / slotCount + 1, slot % slotCount);
+}
+
+int KontoTableFile::getSlotsPerPage(int recordSize, int pageSize, bool slotted) {
+    if (slotted) return (pageSize - (int) POS_PAGE_SLOTS) / (recordSize + 8);
+    int n = (pageSize - POS_PAGE_BITMAP) / recordSize;
+    while (n > 0 && (int) POS_PAGE_BITMAP + (n + 63) / 64 * 8 + n * recordSize > pageSize) n--;
+    return n;
+}
+
+void KontoTableFile::updateLayout() {
+    int pageSize = pmgr.getPageSize();
+    if (slotted) {
+        slotCount = 0;
+        dataOffset = POS_PAGE_SLOTS;
+    } else if (pageHeader) {
+        slotCount = getSlotsPerPage(recordSize, pageSize);
+        dataOffset = POS_PAGE_BITMAP + (slotCount + 63) / 64 * 8;
+    } else {
+        slotCount = pageSize / recordSize;
+        dataOffset = 0;
+    }
+}
+
+void KontoTableFile::clearPage(int page) {
+    PageGuard guard(pmgr, fileID, page);
+    memset(guard.get(), 0, pmgr.getPageSize());
+    pmgr.markDirty(guard.index());
+}
+
+KontoPage KontoTableFile::getRecordPage(const KontoRPos& pos, bool write) {
     int wrpid;
     KontoPage wr = pmgr.getPage(fileID, pos.page, wrpid);
-    char* ptr = wr + pos.id * recordSize;
-    ptr += keys[key].position;
     if (write) pmgr.markDirty(wrpid);
-    return ptr;
+    return wr;
+}
+
+char* KontoTableFile::getFieldPointer(KontoPage page, int id, int position, int size) {
+    if (slotted) {
+        char* slot = page + POS_PAGE_SLOTS + id * 8;
+        char* ptr = page + VI(slot);
+        if (position < 8) return ptr + position;
+        if (VI(slot + 4) <= 8) return emptyRecord + position;
+        ptr += 8;
+        for (auto& key : keys) {
+            if (key.position == (uint) position) return ptr;
+            ptr += storedSize(key, ptr);
+        }
+        assert(false);
+        return nullptr;
+    }
+    if (pax) return page + dataOffset + slotCount * position + id * size;
+    return page + dataOffset + id * recordSize + position;
+}
+
+int KontoTableFile::encodeRecord(const char* record, char* out) {
+    memcpy(out, record, 8);
+    int length = 8;
+    for (auto& key : keys) {
+        int size = storedSize(key, record + key.position);
+        memcpy(out + length, record + key.position, size);
+        length += size;
+    }
+    return length;
+}
+
+void KontoTableFile::decodeRecord(const char* data, uint length, char* out) {
+    memcpy(out, data, 8);
+    if (length <= 8) {
+        memset(out + 8, 0, recordSize - 8);
+        return;
+    }
+    data += 8;
+    for (auto& key : keys) {
+        int size = storedSize(key, data);
+        memcpy(out + key.position, data, size);
+        memset(out + key.position + size, 0, key.size - size);
+        data += size;
+    }
+}
+
+uint KontoTableFile::getFreeBytes(KontoPage page) {
+    uint heap = VI(page + POS_PAGE_HEAPSTART);
+    if (heap == 0) heap = pmgr.getPageSize(); // 新清零的页
+    return heap - (POS_PAGE_SLOTS + VI(page + POS_PAGE_SLOTCOUNT) * 8) + VI(page + POS_PAGE_GARBAGE);
+}
+
+void KontoTableFile::compactPage(KontoPage page) {
+    thread_local char scratch[MAX_PAGE_SIZE];
+    uint pageSize = pmgr.getPageSize(), heap = pageSize;
+    uint n = VI(page + POS_PAGE_SLOTCOUNT);
+    for (uint j=0;j<n;j++) {
+        char* slot = page + POS_PAGE_SLOTS + j * 8;
+        uint length = VI(slot + 4);
+        if (length == 0) continue;
+        char* rec = page + VI(slot);
+        if (VI(rec + 4) & FLAGS_DELETED) length = 8;
+        heap -= length;
+        memcpy(scratch + heap, rec, length);
+        VI(slot) = heap;
+        VI(slot + 4) = length;
+    }
+    memcpy(page + heap, scratch + heap, pageSize - heap);
+    VI(page + POS_PAGE_HEAPSTART) = heap;
+    VI(page + POS_PAGE_GARBAGE) = 0;
+}
+
+void KontoTableFile::placeRecord(KontoPage page, uint id, const char* data, uint length) {
+    if (VI(page + POS_PAGE_HEAPSTART) == 0) VI(page + POS_PAGE_HEAPSTART) = pmgr.getPageSize();
+    uint slotsEnd = POS_PAGE_SLOTS + VI(page + POS_PAGE_SLOTCOUNT) * 8;
+    if (VI(page + POS_PAGE_HEAPSTART) - slotsEnd < length) compactPage(page);
+    uint heap = VI(page + POS_PAGE_HEAPSTART) - length;
+    assert(heap >= slotsEnd);
+    memcpy(page + heap, data, length);
+    VI(page + POS_PAGE_HEAPSTART) = heap;
+    char* slot = page + POS_PAGE_SLOTS + id * 8;
+    VI(slot) = heap;
+    VI(slot + 4) = length;
+}
+
+KontoResult KontoTableFile::insertSlotted(char* record, KontoRPos* out) {
+    thread_local char encoded[MAX_PAGE_SIZE];
+    uint length = encodeRecord(record, encoded);
+    VI(encoded) = recordCount + 1;
+    VI(encoded + 4) = 0;
+    // 只向最后一页追加，其他页中删除留下的空间由页内整理与 vacuum 回收
+    int pid;
+    if (getFreeBytes(pmgr.getPage(fileID, pageCount - 1, pid)) < length + 8) {
+        ++pageCount;
+        clearPage(pageCount - 1);
+    }
+    PageGuard guard(pmgr, fileID, pageCount - 1);
+    KontoPage page = guard.get();
+    if (VI(page + POS_PAGE_HEAPSTART) == 0) VI(page + POS_PAGE_HEAPSTART) = pmgr.getPageSize();
+    // 新槽占用槽数组之后的 8 字节，连续空间不足时先整理
+    uint slotsEnd = POS_PAGE_SLOTS + VI(page + POS_PAGE_SLOTCOUNT) * 8;
+    if (VI(page + POS_PAGE_HEAPSTART) - slotsEnd < length + 8) compactPage(page);
+    uint id = VI(page + POS_PAGE_SLOTCOUNT)++;
+    VI(page + POS_PAGE_SLOTS + id * 8) = 0;
+    VI(page + POS_PAGE_SLOTS + id * 8 + 4) = 0;
+    VI(page + POS_PAGE_LIVECOUNT)++;
+    placeRecord(page, id, encoded, length);
+    pmgr.markDirty(guard.index());
+    ++recordCount; ++existCount;
+    metaDirty = true;
+    if (out) *out = KontoRPos(pageCount - 1, id);
+    return KR_OK;
+}
+
+bool KontoTableFile::rewriteSlotted(const KontoRPos& pos, char* record) {
+    thread_local char encoded[MAX_PAGE_SIZE];
+    uint length = encodeRecord(record, encoded);
+    PageGuard guard(pmgr, fileID, pos.page);
+    KontoPage page = guard.get();
+    char* slot = page + POS_PAGE_SLOTS + pos.id * 8;
+    uint old = VI(slot + 4);
+    if (length <= old) {
+        memcpy(page + VI(slot), encoded, length);
+        VI(slot + 4) = length;
+        VI(page + POS_PAGE_GARBAGE) += old - length;
+        pmgr.markDirty(guard.index());
+        return true;
+    }
+    if (getFreeBytes(page) + old < length) return false;
+    VI(page + POS_PAGE_GARBAGE) += old;
+    VI(slot) = VI(slot + 4) = 0;
+    placeRecord(page, pos.id, encoded, length);
+    pmgr.markDirty(guard.index());
+    return true;
+}
+
+KontoResult KontoTableFile::updateEntry(KontoRPos& pos, char* record) {
+    if (slotted) {
+        if (rewriteSlotted(pos, record)) return KR_OK;
+        deleteEntry(pos);
+        return insertEntry(record, &pos);
+    }
+    PageGuard guard(pmgr, fileID, pos.page);
+    for (auto& key : keys)
+        memcpy(getFieldPointer(guard.get(), pos.id, key.position, key.size), record + key.position, key.size);
+    pmgr.markDirty(guard.index());
+    return KR_OK;
+}
+
+uint KontoTableFile::getSlotTotal() {
+    if (slotted) {
+        uint total = 0;
+        for (int i=1;i<pageCount;i++) {
+            int pid;
+            total += VI(pmgr.getPage(fileID, i, pid) + POS_PAGE_SLOTCOUNT);
+        }
+        return total;
+    }
+    return (pageCount - 2) * slotCount + lastPageCount;
+}
+
+char* KontoTableFile::getDataPointer(const KontoRPos& pos, KontoKeyIndex key, bool write = false){
+    KontoPage wr = getRecordPage(pos, write);
+    return getFieldPointer(wr, pos.id, keys[key].position, keys[key].size);
 }
 
 char* KontoTableFile::getRecordPointer(const KontoRPos& pos, bool write) {
+    assert(!pax && !slotted);
     int wrpid;
     KontoPage wr = pmgr.getPage(fileID, pos.page, wrpid);
-    char* ptr = wr + pos.id * recordSize;
+    char* ptr = wr + dataOffset + pos.id * recordSize;
     if (write) pmgr.markDirty(wrpid);
     return ptr;
 }
@@ -228,7 +554,19 @@ uint KontoTableFile::getRecordSize() {return recordSize;}
 KontoResult KontoTableFile::getDataCopied(const KontoRPos& pos, char* dest) {
     int wrpid;
     KontoPage wr = pmgr.getPage(fileID, pos.page, wrpid);
-    char* ptr = wr + pos.id * recordSize;
+    if (slotted) {
+        char* slot = wr + POS_PAGE_SLOTS + pos.id * 8;
+        decodeRecord(wr + VI(slot), VI(slot + 4), dest);
+        return KR_OK;
+    }
+    if (pax) {
+        memcpy(dest, getFieldPointer(wr, pos.id, 0, 4), 4);
+        memcpy(dest + 4, getFieldPointer(wr, pos.id, 4, 4), 4);
+        for (auto& key : keys)
+            memcpy(dest + key.position, getFieldPointer(wr, pos.id, key.position, key.size), key.size);
+        return KR_OK;
+    }
+    char* ptr = wr + dataOffset + pos.id * recordSize;
     memcpy(dest, ptr, recordSize);
     return KR_OK;
 }
@@ -236,15 +574,17 @@ KontoResult KontoTableFile::getDataCopied(const KontoRPos& pos, char* dest) {
 KontoResult KontoTableFile::editEntryInt(const KontoRPos& pos, KontoKeyIndex key, int datum) {
     if (key<0 || key>=keys.size()) return KR_NO_SUCH_COLUMN;
     if (keys[key].type!=KT_INT) return KR_TYPE_NOT_MATCHING;
-    char* ptr = getDataPointer(pos, key, true);
+    PageGuard guard(pmgr, fileID, pos.page);
+    char* ptr = getFieldPointer(guard.get(), pos.id, keys[key].position, keys[key].size);
     *((int*)ptr) = datum;
+    pmgr.markDirty(guard.index());
     return KR_OK;
 }
 
 KontoResult KontoTableFile::readEntryInt(const KontoRPos& pos, KontoKeyIndex key, int& out) {
     if (key<0 || key>=keys.size()) return KR_NO_SUCH_COLUMN;
     if (keys[key].type!=KT_INT) return KR_TYPE_NOT_MATCHING;
-    char* ptr = getDataPointer(pos, key, true);
+    char* ptr = getDataPointer(pos, key, false);
     out = *((int*)ptr);
     return KR_OK;
 }
@@ -252,15 +592,17 @@ KontoResult KontoTableFile::readEntryInt(const KontoRPos& pos, KontoKeyIndex key
 KontoResult KontoTableFile::editEntryFloat(const KontoRPos& pos, KontoKeyIndex key, double datum) {
     if (key<0 || key>=keys.size()) return KR_NO_SUCH_COLUMN;
     if (keys[key].type!=KT_FLOAT) return KR_TYPE_NOT_MATCHING;
-    char* ptr = getDataPointer(pos, key, true);
+    PageGuard guard(pmgr, fileID, pos.page);
+    char* ptr = getFieldPointer(guard.get(), pos.id, keys[key].position, keys[key].size);
     *((double*)ptr) = datum;
+    pmgr.markDirty(guard.index());
     return KR_OK;
 }
 
 KontoResult KontoTableFile::readEntryFloat(const KontoRPos& pos, KontoKeyIndex key, double& out) {
     if (key<0 || key>=keys.size()) return KR_NO_SUCH_COLUMN;
     if (keys[key].type!=KT_FLOAT) return KR_TYPE_NOT_MATCHING;
-    char* ptr = getDataPointer(pos, key, true);
+    char* ptr = getDataPointer(pos, key, false);
     out = *((double*)ptr);
     return KR_OK;
 }
@@ -268,15 +610,25 @@ KontoResult KontoTableFile::readEntryFloat(const KontoRPos& pos, KontoKeyIndex k
 KontoResult KontoTableFile::editEntryString(const KontoRPos& pos, KontoKeyIndex key, const char* data) {
     if (key<0 || key>=keys.size()) return KR_NO_SUCH_COLUMN;
     if (keys[key].type!=KT_STRING) return KR_TYPE_NOT_MATCHING;
-    char* ptr = getDataPointer(pos, key, true);
+    if (slotted) {
+        char* buffer = new char[recordSize];
+        getDataCopied(pos, buffer);
+        setEntryString(buffer, key, data);
+        bool done = rewriteSlotted(pos, buffer);
+        delete[] buffer;
+        return done ? KR_OK : KR_DATA_TOO_LONG;
+    }
+    PageGuard guard(pmgr, fileID, pos.page);
+    char* ptr = getFieldPointer(guard.get(), pos.id, keys[key].position, keys[key].size);
     strcpy((char*)ptr, data);
+    pmgr.markDirty(guard.index());
     return KR_OK;
 }
 
 KontoResult KontoTableFile::readEntryString(const KontoRPos& pos, KontoKeyIndex key, char* out) {
     if (key<0 || key>=keys.size()) return KR_NO_SUCH_COLUMN;
     if (keys[key].type!=KT_STRING) return KR_TYPE_NOT_MATCHING;
-    char* ptr = getDataPointer(pos, key, true);
+    char* ptr = getDataPointer(pos, key, false);
     strcpy(out, (char*)ptr);
     return KR_OK;
 }
@@ -284,45 +636,91 @@ KontoResult KontoTableFile::readEntryString(const KontoRPos& pos, KontoKeyIndex
 KontoResult KontoTableFile::editEntryDate(const KontoRPos& pos, KontoKeyIndex key, Date datum) {
     if (key<0 || key>=keys.size()) return KR_NO_SUCH_COLUMN;
     if (keys[key].type!=KT_DATE) return KR_TYPE_NOT_MATCHING;
-    char* ptr = getDataPointer(pos, key, true);
+    PageGuard guard(pmgr, fileID, pos.page);
+    char* ptr = getFieldPointer(guard.get(), pos.id, keys[key].position, keys[key].size);
     *((Date*)ptr) = datum;
+    pmgr.markDirty(guard.index());
     return KR_OK;
 }
 
 KontoResult KontoTableFile::readEntryDate(const KontoRPos& pos, KontoKeyIndex key, Date& out) {
     if (key<0 || key>=keys.size()) return KR_NO_SUCH_COLUMN;
     if (keys[key].type!=KT_DATE) return KR_TYPE_NOT_MATCHING;
-    char* ptr = getDataPointer(pos, key, true);
+    char* ptr = getDataPointer(pos, key, false);
     out = *((Date*)ptr);
     return KR_OK;
 }
 
 KontoResult KontoTableFile::allEntries(KontoQRes& out) {
     out = KontoQueryResult();
-    int metapid;
-    KontoPage meta = pmgr.getPage(fileID, 0, metapid);
-    KontoRPos rec;
-    for (int i=1;i<pageCount-1;i++) {
-        int cnt = PAGE_SIZE / recordSize;
-        for (int j=0;j<cnt;j++) 
-            out.push(KontoRPos(i, j));
-    }
-    int last = pageCount - 1;
-    int cnt = VI(meta + POS_META_LASTPAGE);
-    for (int j=0;j<cnt;j++) out.push(KontoRPos(last, j));
+    KontoScanCursor cursor; openScan(cursor);
+    for (int i=cursor.page;i<=cursor.last;i++)
+        scanPage(i, i == cursor.last ? cursor.lastCount : slotCount, out);
+    out.sorted = true;
+    out.optimize();
     return KR_OK;
 }
 
+void KontoTableFile::openScan(KontoScanCursor& cursor) {
+    cursor.page = 1;
+    cursor.last = pageCount - 1;
+    cursor.lastCount = lastPageCount;
+}
+
+bool KontoTableFile::nextScanBatch(KontoScanCursor& cursor, KontoQRes& out) {
+    out = KontoQueryResult();
+    while (cursor.page <= cursor.last && out.size() < SCAN_BATCH) {
+        int i = cursor.page++;
+        scanPage(i, i == cursor.last ? cursor.lastCount : slotCount, out);
+    }
+    out.sorted = true;
+    return out.size() > 0;
+}
+
+void KontoTableFile::closeScan(KontoScanCursor& cursor) {
+    cursor.page = cursor.last + 1;
+}
+
+void KontoTableFile::scanPage(int i, int cnt, KontoQRes& out) {
+    if (!pageHeader) {
+        for (int j=0;j<cnt;j++) out.push(KontoRPos(i, j));
+        return;
+    }
+    // 跳过全部删除的页，其余页按删除位图取出存活的槽
+    int pid;
+    KontoPage page = pmgr.getPage(fileID, i, pid);
+    if (VI(page + POS_PAGE_LIVECOUNT) == 0) return;
+    if (slotted) {
+        uint n = VI(page + POS_PAGE_SLOTCOUNT);
+        for (uint j=0;j<n;j++) {
+            char* slot = page + POS_PAGE_SLOTS + j * 8;
+            if (VI(slot + 4) != 0 && !(VI(page + VI(slot) + 4) & FLAGS_DELETED))
+                out.push(KontoRPos(i, j));
+        }
+        return;
+    }
+    unsigned long long* deleted = VULL(page + POS_PAGE_BITMAP);
+    for (int w=0;w*64<cnt;w++) {
+        unsigned long long live = ~deleted[w];
+        if (cnt - w*64 < 64) live &= (1ULL << (cnt - w*64)) - 1;
+        while (live) {
+            out.push(KontoRPos(i, w*64 + __builtin_ctzll(live)));
+            live &= live - 1;
+        }
+    }
+}
+
 KontoResult KontoTableFile::queryEntryInt(const KontoQRes& from, KontoKeyIndex key, function<bool(int)> cond, KontoQRes& out) {
     if (keys[key].type!=KT_INT) return KR_TYPE_NOT_MATCHING; 
     KontoQRes result; 
-    for (auto& item : from.items) {
-        char* ptr = getRecordPointer(item, false);
-        if (VI(ptr + 4) & FLAGS_DELETED) continue;
-        ptr += keys[key].position;
+    for (auto& item : from) {
+        KontoPage page = getRecordPage(item);
+        if (VI(getFieldPointer(page, item.id, 4, 4)) & FLAGS_DELETED) continue;
+        char* ptr = getFieldPointer(page, item.id, keys[key].position, keys[key].size);
         if (cond(*((int*)ptr))) result.push(item);
     }
-    result.sorted = true;
+    result.sorted = from.sorted;
+    result.optimize();
     out = result;
     return KR_OK;
 }
@@ -330,13 +728,14 @@ KontoResult KontoTableFile::queryEntryInt(const KontoQRes& from, KontoKeyIndex k
 KontoResult KontoTableFile::queryEntryFloat(const KontoQRes& from, KontoKeyIndex key, function<bool(double)> cond, KontoQRes& out) {
     if (keys[key].type!=KT_FLOAT) return KR_TYPE_NOT_MATCHING; 
     KontoQRes result;
-    for (auto& item : from.items) {
-        char* ptr = getRecordPointer(item, false);
-        if (VI(ptr + 4) & FLAGS_DELETED) continue;
-        ptr += keys[key].position;
+    for (auto& item : from) {
+        KontoPage page = getRecordPage(item);
+        if (VI(getFieldPointer(page, item.id, 4, 4)) & FLAGS_DELETED) continue;
+        char* ptr = getFieldPointer(page, item.id, keys[key].position, keys[key].size);
         if (cond(*((double*)ptr))) result.push(item);
     }
-    result.sorted = true;
+    result.sorted = from.sorted;
+    result.optimize();
     out = result;
     return KR_OK;
 }
@@ -344,13 +743,14 @@ KontoResult KontoTableFile::queryEntryFloat(const KontoQRes& from, KontoKeyIndex
 KontoResult KontoTableFile::queryEntryString(const KontoQRes& from, KontoKeyIndex key, function<bool(const char*)> cond, KontoQRes& out) {
     if (keys[key].type!=KT_STRING) return KR_TYPE_NOT_MATCHING; 
     KontoQRes result;
-    for (auto& item : from.items) {
-        char* ptr = getRecordPointer(item, false);
-        if (VI(ptr + 4) & FLAGS_DELETED) continue;
-        ptr += keys[key].position;
+    for (auto& item : from) {
+        KontoPage page = getRecordPage(item);
+        if (VI(getFieldPointer(page, item.id, 4, 4)) & FLAGS_DELETED) continue;
+        char* ptr = getFieldPointer(page, item.id, keys[key].position, keys[key].size);
         if (cond((char*)ptr)) result.push(item);
     }
-    result.sorted = true;
+    result.sorted = from.sorted;
+    result.optimize();
     out = result;
     return KR_OK;
 }
@@ -358,13 +758,14 @@ KontoResult KontoTableFile::queryEntryString(const KontoQRes& from, KontoKeyInde
 KontoResult KontoTableFile::queryEntryDate(const KontoQRes& from, KontoKeyIndex key, function<bool(Date)> cond, KontoQRes& out) {
     if (keys[key].type!=KT_DATE) return KR_TYPE_NOT_MATCHING; 
     KontoQRes result; 
-    for (auto& item : from.items) {
-        char* ptr = getRecordPointer(item, false);
-        if (VI(ptr + 4) & FLAGS_DELETED) continue;
-        ptr += keys[key].position;
+    for (auto& item : from) {
+        KontoPage page = getRecordPage(item);
+        if (VI(getFieldPointer(page, item.id, 4, 4)) & FLAGS_DELETED) continue;
+        char* ptr = getFieldPointer(page, item.id, keys[key].position, keys[key].size);
         if (cond(*((Date*)ptr))) result.push(item);
     }
-    result.sorted = true;
+    result.sorted = from.sorted;
+    result.optimize();
     out = result;
     return KR_OK;
 }
@@ -380,12 +781,16 @@ KontoResult KontoTableFile::getKeyIndex(const char* key, KontoKeyIndex& out) {
 }
 
 KontoQueryResult::KontoQueryResult(const KontoQRes& r) {
-    clear();
+    items = r.items;
+    blocks = r.blocks;
+    compressed = r.compressed;
+    count = r.count;
+    optimizeMark = r.optimizeMark;
     sorted = r.sorted;
-    for (auto item : r.items) items.push_back(item);
 }
 
 KontoQueryResult KontoQueryResult::join(KontoQueryResult& b) {
+    if (compressed || b.compressed) return combine(*this, b, 1);
     KontoQRes ret;
     int sa = size(), sb = b.size();
     if (!sorted) sort();
@@ -401,10 +806,12 @@ KontoQueryResult KontoQueryResult::join(KontoQueryResult& b) {
         }
     }
     ret.sorted = true;
+    ret.optimize();
     return ret;
 }
 
 KontoQueryResult KontoQueryResult::meet(KontoQueryResult& b) {
+    if (compressed || b.compressed) return combine(*this, b, 0);
     KontoQRes ret;
     if (!sorted) sort();
     if (!b.sorted) b.sort();
@@ -420,10 +827,12 @@ KontoQueryResult KontoQueryResult::meet(KontoQueryResult& b) {
         }
     }
     ret.sorted = true;
+    ret.optimize();
     return ret;
 }
 
 KontoQueryResult KontoQueryResult::substract(KontoQueryResult& b) {
+    if (compressed || b.compressed) return combine(*this, b, 2);
     KontoQRes ret;
     int sa = size(), sb = b.size();
     if (!sorted) sort();
@@ -439,6 +848,134 @@ KontoQueryResult KontoQueryResult::substract(KontoQueryResult& b) {
         }
     }
     ret.sorted = true;
+    ret.optimize();
+    return ret;
+}
+
+void KontoQueryResult::expand() {
+    if (!compressed) return;
+    items.clear();
+    items.reserve(count);
+    for (auto item : *this) items.push_back(item);
+    vector<KontoRPosBlock>().swap(blocks);
+    compressed = false;
+}
+
+void KontoQueryResult::pushCompressed(const KontoRPos& p) {
+    if (blocks.size() == 0 || blocks.back().page != p.page) {
+        blocks.push_back(KontoRPosBlock());
+        blocks.back().page = p.page;
+    }
+    KontoRPosBlock& block = blocks.back();
+    count++;
+    if (block.bits.size() == 0) {
+        block.ids.push_back(p.id);
+        // 稀疏容器超过同样范围的位图大小时改为稠密容器
+        if (block.ids.size() * 2 <= (size_t) (p.id / 64 + 1) * 8) return;
+        vector<unsigned long long> words;
+        blockToWords(block, words, p.id / 64 + 1);
+        block.bits.swap(words);
+        vector<unsigned short>().swap(block.ids);
+        return;
+    }
+    if ((size_t) (p.id / 64) >= block.bits.size()) block.bits.resize(p.id / 64 + 1, 0);
+    block.bits[p.id / 64] |= 1ULL << (p.id % 64);
+}
+
+void KontoQueryResult::buildBlocks(const vector<KontoRPos>& list, vector<KontoRPosBlock>& out) {
+    out.clear();
+    vector<unsigned long long> words;
+    int n = list.size();
+    for (int i=0;i<n;) {
+        int page = list[i].page, j = i;
+        while (j<n && list[j].page == page) j++;
+        words.assign(list[j-1].id / 64 + 1, 0);
+        for (int k=i;k<j;k++) words[list[k].id / 64] |= 1ULL << (list[k].id % 64);
+        out.push_back(KontoRPosBlock());
+        out.back().page = page;
+        wordsToBlock(words, out.back());
+        i = j;
+    }
+}
+
+uint KontoQueryResult::blockSize(const KontoRPosBlock& block) {
+    if (block.bits.size() == 0) return block.ids.size();
+    uint total = 0;
+    for (auto w : block.bits) total += __builtin_popcountll(w);
+    return total;
+}
+
+int KontoQueryResult::blockWords(const KontoRPosBlock& block) {
+    if (block.bits.size() > 0) return block.bits.size();
+    return block.ids.size() > 0 ? block.ids.back() / 64 + 1 : 0;
+}
+
+void KontoQueryResult::blockToWords(const KontoRPosBlock& block, vector<unsigned long long>& words, int n) {
+    words.assign(n, 0);
+    if (block.bits.size() > 0) {
+        for (int i=0;i<n && i<(int) block.bits.size();i++) words[i] = block.bits[i];
+        return;
+    }
+    for (auto id : block.ids) if (id / 64 < n) words[id / 64] |= 1ULL << (id % 64);
+}
+
+uint KontoQueryResult::wordsToBlock(const vector<unsigned long long>& words, KontoRPosBlock& block) {
+    int n = words.size();
+    while (n > 0 && words[n-1] == 0) n--;
+    uint total = 0;
+    for (int i=0;i<n;i++) total += __builtin_popcountll(words[i]);
+    block.ids.clear(); block.bits.clear();
+    if (total * 2 > (uint) n * 8) {
+        block.bits.assign(words.begin(), words.begin() + n);
+        return total;
+    }
+    block.ids.reserve(total);
+    for (int i=0;i<n;i++) {
+        unsigned long long w = words[i];
+        while (w) {
+            block.ids.push_back(i * 64 + __builtin_ctzll(w));
+            w &= w - 1;
+        }
+    }
+    return total;
+}
+
+KontoQueryResult KontoQueryResult::combine(KontoQueryResult& a, KontoQueryResult& b, int op) {
+    // 列表形式的一方先排序并临时构建各页容器
+    vector<KontoRPosBlock> ta, tb;
+    if (!a.compressed) {if (!a.sorted) a.sort(); buildBlocks(a.items, ta);}
+    if (!b.compressed) {if (!b.sorted) b.sort(); buildBlocks(b.items, tb);}
+    const vector<KontoRPosBlock>& ba = a.compressed ? a.blocks : ta;
+    const vector<KontoRPosBlock>& bb = b.compressed ? b.blocks : tb;
+    KontoQRes ret;
+    ret.compressed = true;
+    ret.sorted = true;
+    vector<unsigned long long> wa, wb;
+    int i = 0, j = 0, na = ba.size(), nb = bb.size();
+    while (i<na || j<nb) {
+        if (j==nb || (i<na && ba[i].page < bb[j].page)) {
+            // 只在 a 中出现的页，交集中没有，并集与差集中原样保留
+            if (op != 0) {ret.blocks.push_back(ba[i]); ret.count += blockSize(ba[i]);}
+            i++; continue;
+        }
+        if (i==na || bb[j].page < ba[i].page) {
+            if (op == 1) {ret.blocks.push_back(bb[j]); ret.count += blockSize(bb[j]);}
+            j++; continue;
+        }
+        int n = std::max(blockWords(ba[i]), blockWords(bb[j]));
+        blockToWords(ba[i], wa, n);
+        blockToWords(bb[j], wb, n);
+        for (int k=0;k<n;k++) {
+            if (op == 0) wa[k] &= wb[k];
+            else if (op == 1) wa[k] |= wb[k];
+            else wa[k] &= ~wb[k];
+        }
+        KontoRPosBlock block; block.page = ba[i].page;
+        uint c = wordsToBlock(wa, block);
+        if (c > 0) {ret.blocks.push_back(block); ret.count += c;}
+        i++; j++;
+    }
+    if (ret.count < BITMAP_MIN_SIZE) ret.expand();
     return ret;
 }
 
@@ -447,20 +984,23 @@ KontoResult KontoTableFile::createIndex(const vector<KontoKeyIndex>& keyIndices,
     vector<uint> kpos = vector<uint>();
     vector<uint> ktype = vector<KontoKeyType>();
     vector<uint> ksize = vector<uint>();
+    uint indexSize = 0;
     for (auto key: keyIndices) {
         opt.push_back(keys[key].name);
         kpos.push_back(keys[key].position);
         ktype.push_back(keys[key].type);
         ksize.push_back(keys[key].size);
+        indexSize += keys[key].size;
     }
+    if (!KontoIndex::keyFits(indexSize, pmgr.getPageSize())) return KR_KEY_TOO_LONG;
     string indexFilename = KontoIndex::getIndexFilename(filename, opt);
     for (auto& item : indices) {if (item->getFilename() == indexFilename) return KR_INDEX_ALREADY_EXISTS;}
     KontoIndex* ptr;
     KontoResult result = KontoIndex::createIndex(
-        indexFilename, &ptr, ktype, kpos, ksize);
+        indexFilename, &ptr, ktype, kpos, ksize, isCompressed());
     KontoQRes q;
     allEntries(q);
-    for (auto item : q.items) {
+    for (auto item : q) {
         auto res = insertIndex(item, ptr, noRepeat);
         if (res==KR_REPETITION) {ptr->drop(); return KR_REPETITION;}
     }
@@ -545,14 +1085,71 @@ KontoResult KontoTableFile::recreateIndices() {
     for (int i=0;i<n;i++) {
         KontoIndex* ptr;
         KontoIndex::recreate(indices[i], &ptr);
+        if (indices[i] == primaryIndex) primaryIndex = ptr;
+        delete indices[i];
         newIndices.push_back(ptr);
     }
     indices = newIndices;
-    for (auto item : q.items) 
+    for (auto item : q) 
         insertIndex(item);
     return KR_OK;
 }
 
+KontoResult KontoTableFile::vacuum(uint& removed, long long& reclaimed) {
+    long long pagesBefore = pageCount;
+    for (auto index : indices) pagesBefore += index->getPageCount();
+    KontoTableFile* ret;
+    createFile(filename + ".__vacuumtemp", &ret, isCompressed(), pax, slotted);
+    // 元信息页整页复制，列定义、主键与外键保持不变，只重置页数与记录数
+    {
+        int bufindex;
+        char* copied = new char[pmgr.getPageSize()];
+        memcpy(copied, pmgr.getPage(fileID, 0, bufindex), pmgr.getPageSize());
+        PageGuard guard(pmgr, ret->fileID, 0);
+        KontoPage retpage = guard.get();
+        memcpy(retpage, copied, pmgr.getPageSize());
+        delete[] copied;
+        VI(retpage + POS_META_PAGECOUNT) = 2;
+        VI(retpage + POS_META_RECORDCOUNT) = 0;
+        VI(retpage + POS_META_EXISTCOUNT) = 0;
+        VI(retpage + POS_META_LASTPAGE) = 0;
+        VI(retpage + POS_META_FREESLOT) = 0;
+        // 旧格式的表整理后改用带页头的数据页
+        VI(retpage + POS_META_PAGEHEADER) = 1;
+        pmgr.markDirty(guard.index());
+    }
+    ret->loadMeta();
+    ret->keys = keys;
+    ret->recordSize = recordSize;
+    ret->updateLayout();
+    ret->fieldDefined = true;
+    KontoQRes q; allEntries(q);
+    char* buffer = new char[recordSize];
+    removed = 0;
+    for (auto item : q) {
+        getDataCopied(item, buffer);
+        if (VI(buffer + 4) & FLAGS_DELETED) continue;
+        ret->insertEntry(buffer, nullptr);
+    }
+    removed = getSlotTotal() - ret->recordCount;
+    delete[] buffer;
+    // 索引仍然打开，由 recreateIndices 关闭并重建
+    pmgr.getFileManager().closeFile(fileID);
+    remove_file(get_filename(filename));
+    ret->close();
+    rename_file(get_filename(filename + ".__vacuumtemp"), get_filename(filename));
+    pageHeader = true;
+    updateLayout();
+    delete ret;
+    fileID = pmgr.openFile(get_filename(filename).c_str());
+    loadMeta();
+    recreateIndices();
+    long long pagesAfter = pageCount;
+    for (auto index : indices) pagesAfter += index->getPageCount();
+    reclaimed = (pagesBefore - pagesAfter) * pmgr.getPageSize();
+    return KR_OK;
+}
+
 KontoIndex* KontoTableFile::getIndex(uint id){
     return indices[id];
 }
@@ -604,16 +1201,25 @@ KontoResult KontoTableFile::setEntryDate(char* record, KontoKeyIndex key, Date d
 }
 
 bool KontoTableFile::hasPrimaryKey() {
-    int bufindex;
-    KontoPage metapage = pmgr.getPage(fileID, 0, bufindex);
-    return VI(metapage + POS_META_PRIMARYCOUNT) != 0;
+    return primaryKeys.size() != 0;
+}
+
+bool KontoTableFile::isCompressed() {
+    return pmgr.getFileManager().isCompressed(fileID);
 }
 
+bool KontoTableFile::isPax() {return pax;}
+
+bool KontoTableFile::isSlotted() {return slotted;}
+
 KontoResult KontoTableFile::insertEntry(char* record, KontoRPos* out) {
+    if (slotted) return insertSlotted(record, out);
     KontoRPos pos;  KontoResult res = insertEntry(&pos);
     if (res != KR_OK) return res;
-    char* ptr = getRecordPointer(pos, true);
-    memcpy(ptr+8, record+8, recordSize-8);
+    PageGuard guard(pmgr, fileID, pos.page);
+    for (auto& key : keys)
+        memcpy(getFieldPointer(guard.get(), pos.id, key.position, key.size), record + key.position, key.size);
+    pmgr.markDirty(guard.index());
     if (out) *out = pos;
     return KR_OK;
 }
@@ -629,12 +1235,20 @@ KontoResult KontoTableFile::getKeyNames(const vector<uint>& keyIndices, vector<s
 
 KontoResult KontoTableFile::alterAddPrimaryKey(const vector<uint>& primaryKeys) {
     if (hasPrimaryKey()) return KR_PRIMARY_REDECLARATION;
-    int bufindex;
-    KontoPage metapage = pmgr.getPage(fileID, 0, bufindex);
-    KontoPage ptr = metapage + POS_META_PRIMARYCOUNT;
-    VIP(ptr) = primaryKeys.size();
-    for (auto id : primaryKeys) VIP(ptr) = id;
-    pmgr.markDirty(bufindex);
+    // 主键列编号存放在 POS_META_PRIMARYCOUNT 到 POS_META_FOREIGNS 之间
+    if ((primaryKeys.size() + 1) * 4 > POS_META_FOREIGNS - POS_META_PRIMARYCOUNT) return KR_META_FULL;
+    uint indexSize = 0;
+    for (auto id : primaryKeys) indexSize += keys[id].size;
+    if (!KontoIndex::keyFits(indexSize, pmgr.getPageSize())) return KR_KEY_TOO_LONG;
+    {
+        PageGuard guard(pmgr, fileID, 0);
+        KontoPage metapage = guard.get();
+        KontoPage ptr = metapage + POS_META_PRIMARYCOUNT;
+        VIP(ptr) = primaryKeys.size();
+        for (auto id : primaryKeys) VIP(ptr) = id;
+        pmgr.markDirty(guard.index());
+    }
+    this->primaryKeys = primaryKeys;
     auto res = recreatePrimaryIndex();
     //cout << "res = " << res << endl;
     return res;
@@ -650,26 +1264,21 @@ KontoResult KontoTableFile::alterDropPrimaryKey() {
             primaryIndex->drop();
             break;
         }
-    int bufindex;
-    KontoPage metapage = pmgr.getPage(fileID, 0, bufindex);
+    PageGuard guard(pmgr, fileID, 0);
+    KontoPage metapage = guard.get();
     KontoPage ptr = metapage + POS_META_PRIMARYCOUNT;
     VIP(ptr) = 0;
-    pmgr.markDirty(bufindex);
+    pmgr.markDirty(guard.index());
+    primaryKeys.clear();
     return KR_OK;
 }
 
 KontoResult KontoTableFile::recreatePrimaryIndex() {
-    int bufindex;
-    KontoPage metapage = pmgr.getPage(fileID, 0, bufindex);
-    KontoPage ptr = metapage + POS_META_PRIMARYCOUNT;
-    int n = VIP(ptr);
-    if (n==0) return KR_NO_PRIMARY;
-    vector<uint> primaryKeys; 
-    for (int i=0;i<n;i++) primaryKeys.push_back(VIP(ptr));
+    if (!hasPrimaryKey()) return KR_NO_PRIMARY;
     vector<string> primaryKeyNames;
     KontoResult res = getKeyNames(primaryKeys, primaryKeyNames);
     string indexFilename = KontoIndex::getIndexFilename(filename, primaryKeyNames);
-    n = indices.size();
+    int n = indices.size();
     for (int i=0;i<n;i++) {
         if (indices[i]->getFilename() == indexFilename) {
             indices.erase(indices.begin() + i);
@@ -678,10 +1287,12 @@ KontoResult KontoTableFile::recreatePrimaryIndex() {
     }
     res = createIndex(primaryKeys, &primaryIndex, true);
     if (res == KR_REPETITION) {
-        metapage = pmgr.getPage(fileID, 0, bufindex);
+        PageGuard guard(pmgr, fileID, 0);
+        KontoPage metapage = guard.get();
         KontoPage ptr = metapage + POS_META_PRIMARYCOUNT;
         VIP(ptr) = 0;
-        pmgr.markDirty(bufindex);
+        pmgr.markDirty(guard.index());
+        primaryKeys.clear();
     }
     return res;
 }
@@ -689,7 +1300,7 @@ KontoResult KontoTableFile::recreatePrimaryIndex() {
 KontoResult KontoTableFile::alterAddColumn(const KontoCDef& def) {
     removeIndices();
     KontoTableFile* ret;
-    createFile(filename + ".__altertemp", &ret);
+    createFile(filename + ".__altertemp", &ret, isCompressed(), pax, slotted);
     for (auto item : keys) ret->defineField(item);
     KontoCDef newdef(def);
     ret->defineField(newdef);
@@ -700,33 +1311,32 @@ KontoResult KontoTableFile::alterAddColumn(const KontoCDef& def) {
     KontoQRes q; allEntries(q);
     char* buffer = new char[ret->getRecordSize()];
     //cout << "query entries " << q.size() << endl;
-    for (auto item : q.items) {
+    for (auto item : q) {
         getDataCopied(item, buffer);
         if (VI(buffer + 4) & FLAGS_DELETED) continue;
         if (newdef.defaultValue) memcpy(buffer + pos, newdef.defaultValue, newdef.size);
         ret->insertEntry(buffer, nullptr);
     }
-    int bufindex;
-    KontoPage metapage = pmgr.getPage(fileID, 0, bufindex);
-    KontoPage ptr = metapage + POS_META_PRIMARYCOUNT;
-    int n = VIP(ptr);
-    vector<uint> primaryKeys; 
-    for (int i=0;i<n;i++) primaryKeys.push_back(VIP(ptr));
+    vector<uint> savedPrimaryKeys = primaryKeys;
     close(); remove_file(get_filename(filename));
     ret->close();
     rename_file(get_filename(filename + ".__altertemp"), get_filename(filename));
     // copy
     keys = ret->keys;
     indices.clear();
-    recordCount = ret->recordCount;
     recordSize = ret->recordSize;
-    pageCount = ret->pageCount;
-    fileID = pmgr.getFileManager().openFile(get_filename(filename).c_str());
-    metapage = pmgr.getPage(fileID, 0, bufindex);
-    ptr = metapage + POS_META_PRIMARYCOUNT;
-    VIP(ptr) = primaryKeys.size();
-    for (auto id : primaryKeys) VIP(ptr) = id;
-    pmgr.markDirty(bufindex);
+    pageHeader = true;
+    updateLayout();
+    fileID = pmgr.openFile(get_filename(filename).c_str());
+    {
+        PageGuard guard(pmgr, fileID, 0);
+        KontoPage metapage = guard.get();
+        KontoPage ptr = metapage + POS_META_PRIMARYCOUNT;
+        VIP(ptr) = savedPrimaryKeys.size();
+        for (auto id : savedPrimaryKeys) VIP(ptr) = id;
+        pmgr.markDirty(guard.index());
+    }
+    loadMeta();
     recreatePrimaryIndex();
     return KR_OK;
 }
@@ -737,8 +1347,9 @@ KontoResult KontoTableFile::alterDropColumn(string name) {
     KontoResult res = getKeyIndex(name.c_str(), keyId);
     if (res != KR_OK) return res;
     KontoTableFile* ret;
-    createFile(filename + ".__altertemp", &ret);
-    for (int i=0;i<keys.size();i++) if (i!=keyId) ret->defineField(keys[i]);
+    createFile(filename + ".__altertemp", &ret, isCompressed(), pax, slotted);
+    // 传入副本，defineField 会改写列的位置，原表的列定义在复制数据时仍要使用
+    for (int i=0;i<keys.size();i++) if (i!=keyId) {KontoCDef copy = keys[i]; ret->defineField(copy);}
     ret->finishDefineField();
     char* buffer = new char[ret->getRecordSize()];
     char* origin = new char[getRecordSize()];
@@ -747,7 +1358,7 @@ KontoResult KontoTableFile::alterDropColumn(string name) {
     assert(tot - size == ret->getRecordSize());
     //cout << "drop : to copy " << q.size() << endl;
     //int c = 0;
-    for (auto item : q.items) {
+    for (auto item : q) {
         getDataCopied(item, origin);
         if (VI(origin + 4) & FLAGS_DELETED) continue;
         memcpy(buffer, origin, pos);
@@ -755,15 +1366,11 @@ KontoResult KontoTableFile::alterDropColumn(string name) {
         ret->insertEntry(buffer, nullptr);
     }
     //cout << "drop: copied " << c << endl;
-    int bufindex;
-    KontoPage metapage = pmgr.getPage(fileID, 0, bufindex);
-    KontoPage ptr = metapage + POS_META_PRIMARYCOUNT;
     bool savePrimaryIndex = true;
-    int n = VIP(ptr);
-    vector<uint> primaryKeys; 
-    for (int i=0;i<n;i++) {
-        int k = VIP(ptr); if (k == keyId) {savePrimaryIndex = false; break;}
-        primaryKeys.push_back(k > keyId ? (k-1) : k);
+    vector<uint> savedPrimaryKeys; 
+    for (int k : primaryKeys) {
+        if (k == keyId) {savePrimaryIndex = false; break;}
+        savedPrimaryKeys.push_back(k > keyId ? (k-1) : k);
     }
     close(); remove_file(get_filename(filename));
     ret->close();
@@ -771,16 +1378,19 @@ KontoResult KontoTableFile::alterDropColumn(string name) {
     // copy
     keys = ret->keys;
     indices.clear();
-    recordCount = ret->recordCount;
-    //cout << "drop: recordcount " << recordCount << endl;
     recordSize = ret->recordSize;
-    pageCount = ret->pageCount;
-    fileID = pmgr.getFileManager().openFile(get_filename(filename).c_str());
-    metapage = pmgr.getPage(fileID, 0, bufindex);
-    ptr = metapage + POS_META_PRIMARYCOUNT;
-    VIP(ptr) = primaryKeys.size();
-    for (auto id : primaryKeys) VIP(ptr) = id;
-    pmgr.markDirty(bufindex);
+    pageHeader = true;
+    updateLayout();
+    fileID = pmgr.openFile(get_filename(filename).c_str());
+    {
+        PageGuard guard(pmgr, fileID, 0);
+        KontoPage metapage = guard.get();
+        KontoPage ptr = metapage + POS_META_PRIMARYCOUNT;
+        VIP(ptr) = savedPrimaryKeys.size();
+        for (auto id : savedPrimaryKeys) VIP(ptr) = id;
+        pmgr.markDirty(guard.index());
+    }
+    loadMeta();
     recreatePrimaryIndex();
     return KR_OK;
 }
@@ -794,8 +1404,8 @@ KontoResult KontoTableFile::alterChangeColumn(string original, const KontoCDef&
 }
 
 void KontoTableFile::rewriteKeyDefinitions() {
-    int bufindex;
-    KontoPage metapage = pmgr.getPage(fileID, 0, bufindex);
+    PageGuard guard(pmgr, fileID, 0);
+    KontoPage metapage = guard.get();
     //cout << "rew key def " << VI(metapage + POS_META_FOREIGNS) << endl;
     char* ptr = metapage + POS_FIELDS;
     int fc = VI(metapage + POS_META_FIELDCOUNT);
@@ -809,7 +1419,7 @@ void KontoTableFile::rewriteKeyDefinitions() {
         if (col.defaultValue) PD(ptr, col.defaultValue, col.size);
         else PE(ptr, col.size);
     }
-    pmgr.markDirty(bufindex);
+    pmgr.markDirty(guard.index());
 }
 
 KontoResult KontoTableFile::alterRenameColumn(string old, string newname) {
@@ -831,38 +1441,51 @@ KontoIndex* KontoTableFile::getPrimaryIndex() {
 }
 
 KontoResult KontoTableFile::alterAddForeignKey(string name, const vector<uint>& foreignKeys, string foreignTable, const vector<string>& foreignName) {
-    int bufindex;
-    KontoPage metapage = pmgr.getPage(fileID, 0, bufindex);
-    char* ptr = metapage + POS_META_FOREIGNS;
-    int n = VI(ptr); VIP(ptr) = n+1; 
-    //cout << "n = " << n << endl;
-    char buffer[PAGE_SIZE];
-    while (n--) {
-        int c = VIP(ptr); 
-        for (int i=0;i<c;i++) VIP(ptr); 
-        CS(buffer, ptr);
-        CS(buffer, ptr);
-        for (int i=0;i<c;i++) CS(buffer, ptr);
-    }
-    VIP(ptr) = foreignKeys.size(); 
-    for (int i=0;i<foreignKeys.size();i++) {
-        int p = foreignKeys[i];
-        VIP(ptr) = p;
-    }
-    PS(ptr, name);
-    PS(ptr, foreignTable);
-    for (auto& fname: foreignName) {
-        //cout << "fname" << fname << endl;
-        PS(ptr, fname);
+    {
+        PageGuard guard(pmgr, fileID, 0);
+        KontoPage metapage = guard.get();
+        char* ptr = metapage + POS_META_FOREIGNS;
+        char* countPtr = ptr;
+        int n = VIP(ptr), total = n;
+        //cout << "n = " << n << endl;
+        char buffer[PAGE_SIZE];
+        while (n--) {
+            int c = VIP(ptr); 
+            for (int i=0;i<c;i++) VIP(ptr); 
+            CS(buffer, ptr);
+            CS(buffer, ptr);
+            for (int i=0;i<c;i++) CS(buffer, ptr);
+        }
+        // 外键从固定偏移开始连续存放到页尾，小页面上剩余空间有限，写入前先检查
+        uint need = 4 + foreignKeys.size() * 4 + name.length() + 1 + foreignTable.length() + 1;
+        for (auto& fname: foreignName) need += fname.length() + 1;
+        if ((ptr - metapage) + need > (uint) pmgr.getPageSize()) return KR_META_FULL;
+        VI(countPtr) = total + 1;
+        VIP(ptr) = foreignKeys.size(); 
+        for (int i=0;i<foreignKeys.size();i++) {
+            int p = foreignKeys[i];
+            VIP(ptr) = p;
+        }
+        PS(ptr, name);
+        PS(ptr, foreignTable);
+        for (auto& fname: foreignName) {
+            //cout << "fname" << fname << endl;
+            PS(ptr, fname);
+        }
+        pmgr.markDirty(guard.index());
     }
-    pmgr.markDirty(bufindex);
+    loadConstraints();
     rewriteKeyDefinitions();
     return KR_OK;
 }
 
 KontoResult KontoTableFile::alterDropForeignKey(string name) {
-    int bufindex;
-    KontoPage metapage = pmgr.getPage(fileID, 0, bufindex);
+    // 先在解析好的外键中查找，不存在时不改动元信息页
+    bool found = false;
+    for (auto& fk : foreignKeys) if (fk.name == name) found = true;
+    if (!found) return KR_NO_SUCH_FOREIGN;
+    PageGuard guard(pmgr, fileID, 0);
+    KontoPage metapage = guard.get();
     char* ptr = metapage + POS_META_FOREIGNS;
     int n = VI(ptr); VIP(ptr) = n-1; 
     char buffer[PAGE_SIZE], namebuffer[PAGE_SIZE];
@@ -878,17 +1501,13 @@ KontoResult KontoTableFile::alterDropForeignKey(string name) {
     }
     if (!flag) return KR_NO_SUCH_FOREIGN;
     memmove(target, tail, ptr-tail);
-    pmgr.markDirty(bufindex);
+    pmgr.markDirty(guard.index());
+    loadConstraints();
     return KR_OK;
 }
 
 void KontoTableFile::getPrimaryKeys(vector<uint>& cols) {
-    cols.clear();
-    int bufindex;
-    KontoPage metapage = pmgr.getPage(fileID, 0, bufindex);
-    char* ptr = metapage + POS_META_PRIMARYCOUNT;
-    int n = VIP(ptr);
-    while (n--) cols.push_back(VIP(ptr));
+    cols = primaryKeys;
 }
 
 void KontoTableFile::getForeignKeys(
@@ -899,28 +1518,11 @@ void KontoTableFile::getForeignKeys(
 {
     cols.clear(); foreignTable.clear(); foreignName.clear();
     fknames.clear();
-    int bufindex;
-    KontoPage metapage = pmgr.getPage(fileID, 0, bufindex);
-    char* ptr = metapage + POS_META_FOREIGNS;
-    int n = VIP(ptr);
-    // cout << "get primary keys of " << filename << " " << n << endl;
-    while (n--) {
-        int c = VIP(ptr);
-        vector<uint> curcols; curcols.clear();
-        for (int i=0;i<c;i++) curcols.push_back(VIP(ptr));
-        string fkname; 
-        cols.push_back(curcols);
-        CS(fkname, ptr); 
-        fknames.push_back(fkname);
-        string table; 
-        CS(table, ptr);
-        foreignTable.push_back(table);
-        vector<string> foreigncols; foreigncols.clear();
-        for (int i=0;i<c;i++) {
-            string buf; CS(buf, ptr);
-            foreigncols.push_back(buf);
-        }
-        foreignName.push_back(foreigncols);
+    for (auto& fk : foreignKeys) {
+        fknames.push_back(fk.name);
+        cols.push_back(fk.cols);
+        foreignTable.push_back(fk.table);
+        foreignName.push_back(fk.foreignNames);
     }
 }
 
@@ -1015,10 +1617,13 @@ void KontoTableFile::printTable(bool meta, bool pos) {
         cout << "    pagecount=" << pageCount << endl;
     } else cout << "[TABLE]" << endl;
     printTableHeader(pos);
-    KontoQRes q; allEntries(q); 
+    KontoScanCursor cursor; openScan(cursor);
+    KontoQRes q;
     int total = 0;
-    for (auto& item : q.items) 
-        if (printTableEntry(item, pos)) total++;
+    while (nextScanBatch(cursor, q))
+        for (auto& item : q) 
+            if (printTableEntry(item, pos)) total++;
+    closeScan(cursor);
     cout << "Total: " << total << endl;
 }
 
@@ -1028,7 +1633,7 @@ void KontoTableFile::printTable(const KontoQRes& list, bool pos) {
     //cout << "     querycount=" << list.size() << endl;
     printTableHeader(pos);
     int total = 0;
-    for (auto& item: list.items) 
+    for (auto& item: list) 
         if (printTableEntry(item, pos)) total++;
     cout << "Total: " << total << endl;
 }
@@ -1038,18 +1643,98 @@ bool _kontoRPosComp(const KontoRPos& a, const KontoRPos& b) {
 }
 
 void KontoQueryResult::sort() {
-    std::sort(items.begin(), items.end(), _kontoRPosComp);
+    if (!compressed) std::sort(items.begin(), items.end(), _kontoRPosComp);
     sorted = true;
 }
 
+void KontoQueryResult::optimize() {
+    if (compressed || items.size() < BITMAP_MIN_SIZE) return;
+    // 只有严格按位置升序的结果才能改用压缩形式，否则会改变遍历顺序；同时估计压缩形式的大小
+    size_t bytes = 0; int n = items.size();
+    for (int i=0, start=0;i<n;i++) {
+        if (i>0 && !_kontoRPosComp(items[i-1], items[i])) return;
+        if (i==n-1 || items[i+1].page != items[i].page) {
+            size_t cnt = i - start + 1, words = items[i].id / 64 + 1;
+            bytes += sizeof(KontoRPosBlock) + std::min(cnt * 2, words * 8);
+            start = i + 1;
+        }
+    }
+    if (bytes >= n * sizeof(KontoRPos)) return;
+    buildBlocks(items, blocks);
+    count = n;
+    vector<KontoRPos>().swap(items);
+    compressed = true;
+    sorted = true;
+}
+
+void KontoQueryResult::extend(const KontoQRes& b) {
+    if (compressed) {
+        // b 中的位置严格升序且都在本结果之后时直接加入压缩形式，否则先展开
+        const KontoRPosBlock& last = blocks.back();
+        KontoRPos prev(last.page, last.bits.size() > 0 ? 
+            (last.bits.size() - 1) * 64 + 63 - __builtin_clzll(last.bits.back()) : last.ids.back());
+        bool ascending = true;
+        for (auto& item : b) {
+            if (!_kontoRPosComp(prev, item)) {ascending = false; break;}
+            prev = item;
+        }
+        if (ascending) {
+            for (auto& item : b) pushCompressed(item);
+            return;
+        }
+        expand();
+    }
+    sorted = (sorted || size() == 0) && b.sorted;
+    for (auto& item : b) items.push_back(item);
+    // 逐批添加时结果每增长一倍尝试一次改用压缩形式
+    if (items.size() >= BITMAP_MIN_SIZE && items.size() >= optimizeMark * 2) {
+        optimizeMark = items.size();
+        optimize();
+    }
+}
+
 KontoQRes KontoQueryResult::append(const KontoQRes& b) {
     KontoQRes ret = KontoQRes(*this);
-    for (auto& item : b.items) 
-        ret.push(item);
+    ret.expand();
+    for (auto& item : b) 
+        ret.items.push_back(item);
     ret.sorted = false;
     return ret;
 }
 
+KontoQueryResult::const_iterator::const_iterator(const KontoQueryResult* res, bool end):
+    r(res), block(0), pos(0), rest(0)
+{
+    if (!r->compressed) {if (end) pos = r->items.size(); return;}
+    if (end) {block = r->blocks.size(); return;}
+    if (r->blocks.size() > 0 && r->blocks[0].bits.size() > 0) rest = r->blocks[0].bits[0];
+    settle();
+}
+
+void KontoQueryResult::const_iterator::settle() {
+    const vector<KontoRPosBlock>& blocks = r->blocks;
+    while (block < blocks.size()) {
+        const KontoRPosBlock& b = blocks[block];
+        if (b.bits.size() == 0) {
+            if (pos < b.ids.size()) {cur = KontoRPos(b.page, b.ids[pos]); return;}
+        } else {
+            while (rest == 0 && pos + 1 < b.bits.size()) rest = b.bits[++pos];
+            if (rest) {cur = KontoRPos(b.page, pos * 64 + __builtin_ctzll(rest)); return;}
+        }
+        block++; pos = 0;
+        rest = block < blocks.size() && blocks[block].bits.size() > 0 ? blocks[block].bits[0] : 0;
+    }
+    pos = 0; rest = 0;
+}
+
+KontoQueryResult::const_iterator& KontoQueryResult::const_iterator::operator++() {
+    if (!r->compressed) {pos++; return *this;}
+    if (r->blocks[block].bits.size() == 0) pos++;
+    else rest &= rest - 1;
+    settle();
+    return *this;
+}
+
 void KontoTableFile::queryEntryInt(const KontoQRes& q, KontoKeyIndex key, OperatorType op, int vi, KontoQRes& ret) {
     switch (op) {
         case OP_EQUAL:        queryEntryInt(q, key, [vi](int p){return p==vi;}, ret); break;
@@ -1140,13 +1825,14 @@ void KontoTableFile::queryCompare(const KontoQRes& from,
 {
     KontoQRes result; 
     KontoKeyType type = keys[k1].type;
-    uint pos1 = keys[k1].position, pos2 = keys[k2].position;
-    for (auto& item : from.items) {
-        char* ptr = getRecordPointer(item, false);
-        if (VI(ptr + 4) & FLAGS_DELETED) continue;
+    for (auto& item : from) {
+        KontoPage page = getRecordPage(item);
+        if (VI(getFieldPointer(page, item.id, 4, 4)) & FLAGS_DELETED) continue;
+        char* p1 = getFieldPointer(page, item.id, keys[k1].position, keys[k1].size);
+        char* p2 = getFieldPointer(page, item.id, keys[k2].position, keys[k2].size);
         switch (type) {
             case KT_INT: {
-                int v1 = *(int*)(ptr+pos1), v2 = *(int*)(ptr+pos2);
+                int v1 = *(int*)p1, v2 = *(int*)p2;
                 switch (op) {
                     case OP_EQUAL:        if (v1==v2) result.push(item); break;
                     case OP_NOT_EQUAL:    if (v1!=v2) result.push(item); break;
@@ -1158,7 +1844,7 @@ void KontoTableFile::queryCompare(const KontoQRes& from,
                 break;
             }
             case KT_FLOAT: {
-                double v1 = *(double*)(ptr+pos1), v2 = *(double*)(ptr+pos2);
+                double v1 = *(double*)p1, v2 = *(double*)p2;
                 switch (op) {
                     case OP_EQUAL:        if (v1==v2) result.push(item); break;
                     case OP_NOT_EQUAL:    if (v1!=v2) result.push(item); break;
@@ -1170,7 +1856,7 @@ void KontoTableFile::queryCompare(const KontoQRes& from,
                 break;
             }
             case KT_STRING: {
-                const char* v1=ptr+pos1, *v2 = ptr+pos2;
+                const char* v1=p1, *v2 = p2;
                 switch (op) {
                     case OP_EQUAL:        if (strcmp(v1,v2)==0) result.push(item); break;
                     case OP_NOT_EQUAL:    if (strcmp(v1,v2)!=0) result.push(item); break;
@@ -1182,7 +1868,7 @@ void KontoTableFile::queryCompare(const KontoQRes& from,
                 break;
             }
             case KT_DATE: {
-                Date v1 = *(Date*)(ptr+pos1), v2 = *(Date*)(ptr+pos2);
+                Date v1 = *(Date*)p1, v2 = *(Date*)p2;
                 switch (op) {
                     case OP_EQUAL:        if (v1==v2) result.push(item); break;
                     case OP_NOT_EQUAL:    if (v1!=v2) result.push(item); break;
@@ -1196,11 +1882,12 @@ void KontoTableFile::queryCompare(const KontoQRes& from,
         }
     }
     result.sorted = from.sorted;
+    result.optimize();
     out = result;
 }
 
 void KontoTableFile::deletes(const KontoQRes& items) {
-    for (auto& item: items.items) {
+    for (auto& item: items) {
         deleteEntry(item);
         deleteIndex(item);
     }
@@ -1236,41 +1923,18 @@ KontoResult KontoTableFile::checkLegal(char* record, uint checkSingle) {
     }
     //cout << "checked nullability" << endl;
     // check foreign key
-    int bufindex;
-    KontoPage metapage = pmgr.getPage(fileID, 0, bufindex);
-    char* ptr = metapage + POS_META_FOREIGNS;
-    int n = VIP(ptr);
-    //cout << "check foreign key n = " << n << endl;
-    //cout << "n = " << n << endl;
-    string tableName, constraintName;
-    vector<uint> cols; vector<string> foreignNames;
     vector<string> toDrop; toDrop.clear();
-    char* target, *tail; bool flag = false;
-    while (n--) {
-        char* bef = ptr;
-        flag = checkSingle == -1;
-        int c = VIP(ptr); cols.clear();
-        foreignNames.clear();
-        for (int i=0;i<c;i++) {
-            cols.push_back(VIP(ptr)); 
-            if (cols[cols.size()-1]==checkSingle) flag=true;
-        }
-        CS(constraintName, ptr);
-        CS(tableName, ptr);
-        for (int i=0;i<c;i++) {
-            string buffer;
-            CS(buffer, ptr);
-            foreignNames.push_back(buffer);
-        }
+    for (auto& fk : foreignKeys) {
+        bool flag = checkSingle == -1;
+        for (auto col : fk.cols) if (col == checkSingle) flag = true;
         //cout << "flag = " << flag << endl;
         if (!flag) continue;
-        KontoResult foreignCheck = checkForeignKey(record, cols, tableName, foreignNames);
-        //cout << "foreignCheck in " << filename << "(" << cols[0] << tableName << foreignNames[0] << ") = " << foreignCheck << endl;
+        KontoResult foreignCheck = checkForeignKey(record, fk.cols, fk.table, fk.foreignNames);
+        //cout << "foreignCheck in " << filename << "(" << fk.cols[0] << fk.table << fk.foreignNames[0] << ") = " << foreignCheck << endl;
         if (foreignCheck == KR_FOREIGN_KEY_FAIL) return foreignCheck;
         if (foreignCheck == KR_FOREIGN_TABLE_NONEXIST || foreignCheck == KR_FOREIGN_COLUMN_UNMATCH) 
-            toDrop.push_back(constraintName);
+            toDrop.push_back(fk.name);
     }
-    //cout << "check foreign keyx n = " << VI(metapage + POS_META_FOREIGNS) << endl;
     //cout << "checked foreign key" << endl;
     for (auto& item : toDrop) alterDropForeignKey(item);
     return KR_OK;
@@ -1283,18 +1947,20 @@ KontoResult KontoTableFile::checkForeignKey(char* record, const vector<uint> col
     KontoTableFile* handle; 
     if (!file_exist(tableDir, get_filename(tableName))) return KR_FOREIGN_TABLE_NONEXIST;
     //if (filename == tableDir + "/" + tableName) return KR_OK; // do not check self foreign-key
-    loadFile(tableDir + "/" + tableName, &handle);
+    KontoTerminal* term = KontoTerminal::getInstance();
+    // 自引用的外键使用本句柄：终端按表名可能另开同一个表的句柄，两者缓存的元信息互不可见
+    bool self = filename == tableDir + "/" + tableName;
+    if (self) handle = this;
+    else term->loadTable(tableName, &handle);
     vector<uint> foreignCols; foreignCols.clear();
     int nCols = cols.size();
     for (int i=0;i<nCols;i++) {
         uint kid;
         KontoResult res = handle->getKeyIndex(foreignNames[i].c_str(), kid);
-        if (res != KR_OK) {handle->close(); return KR_FOREIGN_COLUMN_UNMATCH;}
-        if (handle->keys[kid].type != keys[cols[i]].type) {handle->close(); return KR_FOREIGN_COLUMN_UNMATCH;}
+        if (res != KR_OK) return KR_FOREIGN_COLUMN_UNMATCH;
+        if (handle->keys[kid].type != keys[cols[i]].type) return KR_FOREIGN_COLUMN_UNMATCH;
         foreignCols.push_back(kid);
     }
-    handle->close();
-    KontoTerminal* term = KontoTerminal::getInstance();
     vector<KontoWhere> wheres; wheres.clear();
     for (int i=0;i<nCols;i++) {
         Token rvalue = Token();
@@ -1336,22 +2002,50 @@ KontoResult KontoTableFile::checkForeignKey(char* record, const vector<uint> col
     }
     KontoQRes q;
     //term->printWheres(wheres);
-    term->queryWheres(wheres, q);
+    if (self) findEqual(record, cols, foreignCols, q);
+    else term->queryWheres(wheres, q);
     if (q.size() == 0) return KR_FOREIGN_KEY_FAIL;
     return KR_OK;
 }
 
+void KontoTableFile::findEqual(char* record, const vector<uint>& cols, const vector<uint>& targets, KontoQRes& out) {
+    // 第一列有单列索引且长度相同时用索引缩小范围，其余各列逐列过滤
+    int n = cols.size(), first = 0;
+    KontoIndex* index = getIndex(single_uint_vector(targets[0]));
+    if (index != nullptr && keys[cols[0]].size == keys[targets[0]].size) {
+        char* probe = new char[recordSize]();
+        memcpy(probe + keys[targets[0]].position, record + keys[cols[0]].position, keys[cols[0]].size);
+        index->queryInterval(probe, probe, out, true, true, false);
+        delete[] probe;
+        first = 1;
+    } else allEntries(out);
+    for (int i=first;i<n;i++) {
+        char* value = record + keys[cols[i]].position;
+        KontoQRes next;
+        switch (keys[cols[i]].type) {
+            case KT_INT: queryEntryInt(out, targets[i], OP_EQUAL, *(int*)value, next); break;
+            case KT_FLOAT: queryEntryFloat(out, targets[i], OP_EQUAL, *(double*)value, next); break;
+            case KT_STRING: queryEntryString(out, targets[i], OP_EQUAL, value, next); break;
+            case KT_DATE: queryEntryDate(out, targets[i], OP_EQUAL, *(Date*)value, next); break;
+            default: assert(false);
+        }
+        out = next;
+    }
+}
+
 KontoResult KontoTableFile::alterRename(string newname) { 
-    int bufindex;
-    KontoPage metapage = pmgr.getPage(fileID, 0, bufindex);
-    char* ptr = metapage + POS_FILENAME;
-    PS(ptr, newname);
-    pmgr.markDirty(bufindex);
-    pmgr.closeFile(fileID);
+    flushMeta();
+    {
+        PageGuard guard(pmgr, fileID, 0);
+        KontoPage metapage = guard.get();
+        char* ptr = metapage + POS_FILENAME;
+        PS(ptr, newname);
+        pmgr.markDirty(guard.index());
+    }
     rename_file(get_filename(filename), get_filename(newname));
     string fullFilename = get_filename(newname);
-    fileID = pmgr.getFileManager().openFile(fullFilename.c_str());
+    fileID = pmgr.openFile(fullFilename.c_str());
     for (auto& id : indices) {id->renameTable(newname);}
     filename = newname;
     return KR_OK;
-}
\ No newline at end of file
+}
\ No newline at end of file
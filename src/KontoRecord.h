@@ -70,21 +70,73 @@ struct KontoRPos {
     bool operator !=(const KontoRPos& b){return page!=b.page || id!=b.id;}
 };
 
-// 表查询结果，用向量实现，每个条目为KontoRPos。
+// 查询结果条数达到该值后才考虑改用压缩位图
+const int BITMAP_MIN_SIZE = 1024;
+
+// 压缩位图中一页的容器（与 Roaring 位图相同）：页内记录少时存放有序的页内编号，多时存放位图
+struct KontoRPosBlock {
+    int page;
+    vector<unsigned short> ids; // 稀疏容器，bits 为空时使用
+    vector<unsigned long long> bits; // 稠密容器，位 i 表示页内编号 i
+};
+
+/** 表查询结果，每个条目为KontoRPos。有两种表示：
+ * 列表形式为KontoRPos的向量，可以是任意顺序；
+ * 压缩形式为按页分块的位图，只能表示按位置严格升序的结果，求交、并、差时逐字运算。
+ * 结果按位置有序、条数较多且位图更省空间时自动改用压缩形式，遍历顺序不变。
+ * 压缩形式只改变结果的存放方式：多个 WHERE 条件仍由前一条件的结果逐条过滤得到，
+ * 逐字的求交、并、差目前不在查询路径上。
+ * */
 struct KontoQueryResult {
 private:
     friend class KontoTableFile;
     friend class KontoIndex;
-    // 应当保持严格升序，主关键字page，副关键字id
+    // 列表形式的条目
     vector<KontoRPos> items;
+    // 压缩形式的各页容器，按页号升序
+    vector<KontoRPosBlock> blocks;
+    bool compressed; // 当前是否为压缩形式
+    uint count; // 压缩形式的条目数
+    uint optimizeMark; // 上次尝试改用压缩形式时的条目数
     bool sorted;
     // 向末尾插入
-    void push(const KontoRPos& p){items.push_back(p);}
+    void push(const KontoRPos& p){expand(); items.push_back(p);}
+    // 向压缩形式的末尾添加一条，位置须大于已有的全部条目。
+    void pushCompressed(const KontoRPos& p);
+    // 由按位置升序的列表构建各页容器，重复的条目只保留一个。
+    static void buildBlocks(const vector<KontoRPos>& list, vector<KontoRPosBlock>& out);
+    // 一页容器中的条目数。
+    static uint blockSize(const KontoRPosBlock& block);
+    // 一页容器展开为位图所需的字数。
+    static int blockWords(const KontoRPosBlock& block);
+    // 将一页的容器展开为 n 个字的位图。
+    static void blockToWords(const KontoRPosBlock& block, vector<unsigned long long>& words, int n);
+    // 由位图构建一页的容器，按密度选择稀疏或稠密容器，返回条目数。
+    static uint wordsToBlock(const vector<unsigned long long>& words, KontoRPosBlock& block);
+    // 以压缩形式求交（op=0）、并（op=1）或差（op=2）。
+    static KontoQueryResult combine(KontoQueryResult& a, KontoQueryResult& b, int op);
 public:
+    // 按顺序遍历查询结果的只读迭代器，两种形式均可遍历。
+    class const_iterator {
+        const KontoQueryResult* r;
+        size_t block, pos; // 列表形式中 pos 为下标；压缩形式中为容器编号，以及容器内的下标或字编号
+        unsigned long long rest; // 稠密容器当前字中尚未遍历的位
+        KontoRPos cur;
+        // 压缩形式中移到下一个存在的条目，或移到末尾。
+        void settle();
+    public:
+        const_iterator(const KontoQueryResult* res, bool end);
+        const KontoRPos& operator*() const {return r->compressed ? cur : r->items[pos];}
+        const_iterator& operator++();
+        bool operator!=(const const_iterator& b) const {return block!=b.block || pos!=b.pos || rest!=b.rest;}
+    };
+    const_iterator begin() const {return const_iterator(this, false);}
+    const_iterator end() const {return const_iterator(this, true);}
     // 初始化空的向量。
-    KontoQueryResult(){items=vector<KontoRPos>(); sorted = false;}
+    KontoQueryResult(){items=vector<KontoRPos>(); compressed = false; count = optimizeMark = 0; sorted = false;}
     // 拷贝构造。
     KontoQueryResult(const KontoQueryResult& r);
+    KontoQueryResult& operator =(const KontoQueryResult& r) = default;
     /** 将本结果与另一个结果求并。
      * @param b 另一个结果。
      * @return 并。
@@ -105,15 +157,27 @@ public:
      * @return 两结果列表的拼接。
      * */
     KontoQueryResult append(const KontoQueryResult& b);
+    /** 将另一个结果列表原地添加到本列表之后。两者均已排序且 b 的位置都在本列表之后时，结果仍为有序。
+     * @param b 另一个结果。
+     * */
+    void extend(const KontoQueryResult& b);
+    /** 按密度选择表示：结果按位置严格升序、不少于 BITMAP_MIN_SIZE 条且压缩形式更省空间时改用压缩形式。
+     * */
+    void optimize();
+    // 当前是否为压缩形式。
+    bool isCompressed() const {return compressed;}
     // 查询结果中的记录数目。
-    uint size() const {return items.size();}
+    uint size() const {return compressed ? count : items.size();}
     // 清空查询结果向量。
-    void clear(){items.clear();}
-    /** 获取查询结果的某一项。
+    void clear(){items.clear(); blocks.clear(); compressed = false; count = optimizeMark = 0;}
+    /** 将压缩形式展开为列表形式，之后才能用 get 按编号访问。正在进行的遍历随之失效。
+     * */
+    void expand();
+    /** 获取查询结果的某一项。结果须为列表形式，压缩形式须先调用 expand。
      * @param id 编号。
      * @return 结果。
      * */
-    const KontoRPos& get(int id) const {return items[id];}
+    const KontoRPos& get(int id) const {assert(!compressed); return items[id];}
     /** 将查询结果排序，主关键字为所在页面page，次关键字为页面中的编号id。
      * */
     void sort();
@@ -122,6 +186,24 @@ public:
 // 表查询结果，用向量实现，每个条目为KontoRPos。
 typedef KontoQueryResult KontoQRes;
 
+// 顺序扫描每批取出的记录位置数的下限，一批总是包含整页
+const int SCAN_BATCH = 4096;
+
+// 表的顺序扫描游标，由 KontoTableFile::openScan 打开，按页顺序逐批取出存活记录的位置
+struct KontoScanCursor {
+    int page; // 下一个要读取的数据页
+    int last; // 打开游标时的最后一页
+    int lastCount; // 打开游标时最后一页的条目数
+};
+
+// 外键定义，由元信息页解析而来
+struct KontoForeignKey {
+    string name; // 外键名
+    vector<uint> cols; // 本表中的列编号
+    string table; // 指向的表名
+    vector<string> foreignNames; // 指向的表中对应的列名
+};
+
 // 数据表。
 class KontoTableFile {
     friend class KontoTerminal;
@@ -135,8 +217,56 @@ private:
     int fileID;
     int pageCount; // 页的数量
     int recordSize; // 一条记录所占用空间大小（以char=1为单位）
+    bool pageHeader; // 数据页是否带有存活计数与删除位图的页头，旧格式的表没有
+    int slotCount; // 每个数据页的槽数
+    int dataOffset; // 数据页中第一条记录的偏移，即页头的长度
+    bool pax; // 数据页是否采用 PAX 布局，即页内按列分组存放
+    bool slotted; // 数据页是否为变长记录的槽页
+    // 以下元信息在打开表时从元信息页解析一次，插入与删除只修改内存中的副本，由 flushMeta 写回
+    uint existCount; // 当前表中未删除的记录条数
+    uint lastPageCount; // 最后一页已有的条目数
+    uint freeSlot; // 空闲槽链表的表头，槽号加一，0表示链表为空
+    bool metaDirty; // 内存中的计数是否尚未写回元信息页
+    vector<uint> primaryKeys; // 主键列编号，没有主键时为空
+    vector<KontoForeignKey> foreignKeys;
     string filename;
     KontoIndex* primaryIndex;
+    // 从元信息页读取页数、记录数、空闲槽链表与约束。
+    void loadMeta();
+    // 从元信息页解析主键与外键，修改约束后调用。
+    void loadConstraints();
+    // 记录位置与空闲槽链表中的槽号互相转换。
+    uint getSlotNumber(const KontoRPos& pos);
+    KontoRPos getSlotPosition(uint slot);
+    // 由记录长度与页大小计算 slotCount 与 dataOffset，记录长度或页格式改变后调用。
+    void updateLayout();
+    // 已分配的槽数，包括已删除的。
+    uint getSlotTotal();
+    // 将一个数据页中存活记录的位置追加到 out，cnt 为该页的条目数。
+    void scanPage(int page, int cnt, KontoQRes& out);
+    // 清零新的数据页，页头须从零开始，不依赖新页面读入时的内容。
+    void clearPage(int page);
+    // 获取记录所在的数据页。
+    KontoPage getRecordPage(const KontoRPos& pos, bool write = false);
+    /** 记录中从 position 开始、长度为 size 的一段数据在页中的位置。
+     * 行式布局中一条记录连续存放；PAX 布局中每列（rid 与控制位各算一列）
+     * 在页内连续存放为一个小页，小页起始于 dataOffset + slotCount * position。
+     * */
+    char* getFieldPointer(KontoPage page, int id, int position, int size);
+    // 将定长的记录编码为槽页中的变长形式，返回编码后的长度。
+    int encodeRecord(const char* record, char* out);
+    // 将槽页中的记录还原为定长形式。
+    void decodeRecord(const char* data, uint length, char* out);
+    // 槽页中整理后可用的字节数。
+    uint getFreeBytes(KontoPage page);
+    // 整理槽页，去掉记录区中废弃的字节，已删除的记录只保留 rid 与控制位。
+    void compactPage(KontoPage page);
+    // 在槽页的记录区中为第 id 个槽存放一条记录，调用前须确认空间足够。
+    void placeRecord(KontoPage page, uint id, const char* data, uint length);
+    // 向槽页的表插入一条记录，只追加到最后一页，放不下时新开一页。
+    KontoResult insertSlotted(char* record, KontoRPos* out);
+    // 在槽页中原位置改写一条记录，本页放不下时不做修改并返回 false。
+    bool rewriteSlotted(const KontoRPos& pos, char* record);
     // 在当前目录下查找已有的索引文件并加载。
     void loadIndices(); 
     /** 重新创建主索引。例如当删除某非主索引列，应当重新创建主索引。
@@ -148,8 +278,17 @@ public:
     /** 创建新的表。创建后应该调用defineField声明各个属性，finishDefineField结束声明。
      * @param filename 文件名。
      * @param handle 成功创建后返回指针。
+     * @param compressed 是否压缩存储，表的索引也随之压缩。
+     * @param pax 是否采用 PAX 布局。按单列过滤时只需读取该列的小页，整行读取时再拼合。
+     * @param slotted 是否采用变长记录的槽页，字符串列只占用实际长度。不能与 pax 同时使用。
      * */
-    static KontoResult createFile(string filename, KontoTableFile** handle);
+    static KontoResult createFile(string filename, KontoTableFile** handle, bool compressed = false, bool pax = false, bool slotted = false);
+    /** 带页头的数据页能容纳的记录数，为 0 时说明记录过长。
+     * @param recordSize 记录长度。
+     * @param pageSize 页大小。
+     * @param slotted 是否为槽页，此时按记录的最大长度计算。
+     * */
+    static int getSlotsPerPage(int recordSize, int pageSize, bool slotted = false);
     /** 载入已有的表文件。
      * @param filename 文件名。
      * @param handle 成功读取后返回指针。
@@ -170,11 +309,18 @@ public:
     KontoResult finishDefineField();
     // 关闭文件。
     KontoResult close();
-    /** 插入数据记录。
+    // 将内存中的页数与记录数等计数写回元信息页。语句结束、检查点与关闭文件时调用。
+    void flushMeta();
+    /** 插入数据记录，优先复用已删除记录的位置。槽页的表须改用 insertEntry(record, pos)。
      * @param pos 插入后通过pos返回其位置。
      * */
     KontoResult insertEntry(KontoRPos* pos);
-    /** 删除指定位置的记录。
+    /** 用完整的一行数据改写已有的记录，rid 与控制位以外的各列均被覆盖。
+     * @param pos 记录位置。槽页的表中记录变长而原页放不下时，记录移到其他页，pos 随之更新。
+     * @param record 新的数据。
+     * */
+    KontoResult updateEntry(KontoRPos& pos, char* record);
+    /** 删除指定位置的记录，其位置加入空闲槽链表。
      * @param pos 记录位置。
      * */
     KontoResult deleteEntry(const KontoRPos& pos);
@@ -184,7 +330,7 @@ public:
      * @param datum 新值。
      * */
     KontoResult editEntryInt(const KontoRPos& pos, KontoKeyIndex key, int datum);
-    /** 修改指定位置的记录的string域。
+    /** 修改指定位置的记录的string域。槽页的表中新值在原页放不下时返回 KR_DATA_TOO_LONG，应改用 updateEntry。
      * @param pos 记录位置。
      * @param key 列编号。
      * @param datum 新值。
@@ -258,6 +404,18 @@ public:
      * @param out 返回列表。
      * */
     KontoResult allEntries(KontoQRes& out);
+    /** 打开顺序扫描游标。扫描范围为打开时已有的记录，内存占用与表的大小无关。
+     * @param cursor 返回的游标。
+     * */
+    void openScan(KontoScanCursor& cursor);
+    /** 取出下一批存活记录的位置，按位置升序。
+     * @param cursor 游标。
+     * @param out 返回本批的位置，至少为 SCAN_BATCH 条，除非已到表尾。
+     * @return 本批为空、扫描结束时返回 false。
+     * */
+    bool nextScanBatch(KontoScanCursor& cursor, KontoQRes& out);
+    // 关闭顺序扫描游标，之后 nextScanBatch 不再返回记录。
+    void closeScan(KontoScanCursor& cursor);
     /** 根据列名获取列编号。
      * @param key 列名。
      * @param out 返回结果。
@@ -275,6 +433,7 @@ public:
      * @param keyIndices 列编号的列表。对于单列索引，keyIndices仅一个元素，对于联合索引则有多个元素。
      * @param handle 非空指针时，返回创建索引的指针。
      * @param noRepeat 该索引是否允许重复值。
+     * @return 键长超出页大小允许的范围时返回 KR_KEY_TOO_LONG。
      * */
     KontoResult createIndex(const vector<KontoKeyIndex>& keyIndices, KontoIndex** handle, bool noRepeat);
     // 删除所有索引表
@@ -289,6 +448,11 @@ public:
     KontoResult deleteIndex(const KontoRPos& pos);
     // 重新生成索引表
     KontoResult recreateIndices();
+    /** 整理表文件：去掉已删除的记录，将其余记录依次紧凑存放，并按新的位置重建全部索引。
+     * @param removed 返回去掉的已删除记录数。
+     * @param reclaimed 返回表文件与索引文件减少的字节数。
+     * */
+    KontoResult vacuum(uint& removed, long long& reclaimed);
     /** 获取索引表的指针
      * @param id 索引表的编号。
      * @return 指向获取到的索引表的指针。
@@ -298,6 +462,12 @@ public:
     uint getIndexCount();
     // 是否定义了主索引。
     bool hasPrimaryKey();
+    // 表文件是否压缩存储。
+    bool isCompressed();
+    // 数据页是否采用 PAX 布局。
+    bool isPax();
+    // 数据页是否为变长记录的槽页。
+    bool isSlotted();
     /** 根据列编号获取对应索引。
      * @param keyIndices 列编号。
      * @return 当对应索引存在，返回其指针，否则返回空指针。
@@ -336,7 +506,7 @@ public:
     /** 获取指向记录位置数据的指针，并指出接下来是读取还是写入。
      * @param pos 数据行的位置。
      * @param write 是否接下来要写入。
-     * @return 指向数据记录对应列的指针。
+     * @return 指向数据记录对应列的指针。仅用于行式布局，PAX 布局的记录不连续存放。
      * */
     char* getRecordPointer(const KontoRPos& pos, bool write);
     /** 从列编号获取列名。
@@ -354,6 +524,7 @@ public:
     void rewriteKeyDefinitions();
     /** 添加主键。
      * @param primaryKeys 主键列编号。
+     * @return 主键列过多、元信息页放不下时返回 KR_META_FULL；键长超出页大小允许的范围时返回 KR_KEY_TOO_LONG。
      * */
     KontoResult alterAddPrimaryKey(const vector<uint>& primaryKeys);
     /** 删除主键。 */
@@ -363,6 +534,7 @@ public:
      * @param foreignKeys 外键列编号。
      * @param foreignTable 外键指向的表名。
      * @param foreignName 外键指向的表中的对应列名。
+     * @return 元信息页剩余空间不足以存放该外键时返回 KR_META_FULL，不做任何修改。
      * */
     KontoResult alterAddForeignKey(string name, const vector<uint>& foreignKeys, string foreignTable, const vector<string>& foreignName);
     /** 删除外键。
@@ -534,10 +706,17 @@ public:
      * @param foreignNames 外键指向的表中的对应列名。
      * */
     KontoResult checkForeignKey(char* record, const vector<uint> cols, const string& tableName, const vector<string>& foreignNames);
+    /** 在本表中查找指定列与给定记录对应列全部相等的记录。
+     * @param record 数据指针。
+     * @param cols 给定记录中的列编号。
+     * @param targets 本表中对应的列编号。
+     * @param out 输出查询结果。
+     * */
+    void findEqual(char* record, const vector<uint>& cols, const vector<uint>& targets, KontoQRes& out);
     /** 检查删除标记。
      * @param flags 标记。
      * */
     static bool checkDeletedFlags(uint flags);
 };
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
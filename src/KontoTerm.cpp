@@ -1,10 +1,11 @@
 #include "KontoTerm.h"
 #include <fstream>
+#include <sstream>
+#include <iomanip>
 
 using std::to_string;
 
 #define ASSERTERR(token, type, message) if (token.tokenKind != type) return err(message)
-#define ASSERTERR_CLOSE(token, type, message) if (token.tokenKind != type) {handle->close(); return err(message);}
 
 string bool_to_string(bool b){
     return b ? "Yes" : "No";
@@ -53,6 +54,13 @@ ProcessStatementResult KontoTerminal::processStatement() {
             } 
         }
 
+        case TK_CHECKPOINT: {
+            flushTables();
+            int pages = BufPageManager::getInstance().checkpoint();
+            PT(1, "Checkpoint: " + to_string(pages) + " pages written.");
+            return PSR_OK;
+        }
+
         case TK_CREATE: {
             return processCreate();
         }
@@ -167,13 +175,27 @@ ProcessStatementResult KontoTerminal::processStatement() {
             return PSR_QUIT;
         }
 
+        case TK_RESET: {
+            cur = lexer.nextToken();
+            ASSERTERR(cur, TK_BUFFER, "reset: Expect keyword BUFFER.");
+            cur = lexer.nextToken();
+            ASSERTERR(cur, TK_STATS, "reset buffer: Expect keyword STATS.");
+            BufPageManager::getInstance().resetStats();
+            return PSR_OK;
+        }
+
         case TK_SELECT: {
             return processSelect();
         }
 
         case TK_SHOW: {
             Token peek = lexer.peek();
-            if (peek.tokenKind == TK_DATABASE) {
+            if (peek.tokenKind == TK_BUFFER) {
+                lexer.nextToken(); cur = lexer.nextToken();
+                ASSERTERR(cur, TK_STATS, "show buffer: Expect keyword STATS.");
+                showBufferStats();
+                return PSR_OK;
+            } else if (peek.tokenKind == TK_DATABASE) {
                 lexer.nextToken(); cur = lexer.nextToken(TE_IDENTIFIER);
                 ASSERTERR(cur, TK_IDENTIFIER, "show database: Expect identifier");
                 showDatabase(cur.identifier);
@@ -195,7 +217,7 @@ ProcessStatementResult KontoTerminal::processStatement() {
                 }
                 return PSR_OK;
             } else {
-                return err("show: Expect keyword DATABASE, DATABASES or TABLE.");
+                return err("show: Expect keyword BUFFER, DATABASE, DATABASES or TABLE.");
             }
         }
 
@@ -218,6 +240,18 @@ ProcessStatementResult KontoTerminal::processStatement() {
             }
         }
 
+        case TK_VACUUM: {
+            if (currentDatabase == "") {PT(1, "Error: Not using a database!");return PSR_ERR;}
+            peek = lexer.peek();
+            if (peek.tokenKind == TK_IDENTIFIER) {
+                lexer.nextToken(); vacuumTable(peek.identifier);
+            } else {
+                vector<string> all = tables;
+                for (auto& table : all) vacuumTable(table);
+            }
+            return PSR_OK;
+        }
+
         default: {
             return err("Invalid command.");
         }
@@ -231,24 +265,42 @@ void KontoTerminal::main(bool prompt) {
         if (commandLine) cout << ">>> ";
         ProcessStatementResult psr = processStatement();
         if (psr==PSR_QUIT) break;
+        flushTables();
+        trimTables();
         std::cin.clear(); std::cin.ignore(1024, '\n'); lexer.clearBuffer();
     }
+    // 缓存页面仅在换出或退出时写回
+    unloadTables();
+    BufPageManager::getInstance().close();
 }
 
 KontoTerminal::KontoTerminal() : lexer(true) {
     currentDatabase = "";
     commandLine = true;
+    tableClock = 0;
 }
 
-void KontoTerminal::createDatabase(string dbname) {
+void KontoTerminal::createDatabase(string dbname, int pageSize) {
     if (directory_exist(dbname)) {
         PT(1, "Error: Directory already exists!");
-    } else 
+    } else {
         create_directory(dbname);
+        if (pageSize != PAGE_SIZE)
+            save_lines(dbname, get_filename(PAGESIZE_FILE), vector<string>{to_string(pageSize)});
+    }
+}
+
+// 数据库的页大小记录在 __pagesize.txt 中，没有该文件的数据库使用 PAGE_SIZE。
+int KontoTerminal::getPageSize(string dbname) {
+    if (!file_exist(dbname, get_filename(PAGESIZE_FILE))) return PAGE_SIZE;
+    vector<string> lines = get_lines(dbname, get_filename(PAGESIZE_FILE));
+    return lines.size() > 0 ? std::stoi(lines[0]) : PAGE_SIZE;
 }
 
 void KontoTerminal::useDatabase(string dbname) {
     if (directory_exist(dbname)) {
+        unloadTables();
+        BufPageManager::getInstance().setPageSize(getPageSize(dbname));
         currentDatabase = dbname;
         if (file_exist(dbname, "__tables.txt"))
             tables = get_lines(dbname, "__tables.txt");
@@ -261,6 +313,7 @@ void KontoTerminal::useDatabase(string dbname) {
 
 void KontoTerminal::dropDatabase(string dbname) {
     if (directory_exist(dbname)) {
+        unloadTables();
         remove_directory(dbname);
     } else {
         PT(1, "Error: No such database!");
@@ -273,6 +326,7 @@ void KontoTerminal::showDatabase(string dbname) {
         if (file_exist(dbname, get_filename(TABLES_FILE)))
             t = get_lines(dbname, get_filename(TABLES_FILE));
         PT(1, "[DATABASE " + dbname + "]");
+        PT(2, "Page size: " + to_string(getPageSize(dbname)) + " bytes.");
         if (t.size() > 0) {
             PT(2, "Available tables: ");
             for (auto item : t) 
@@ -292,11 +346,48 @@ void KontoTerminal::showDatabases() {
     if (dirs.size()==0) PT(1, "No available databases.");
 }
 
-void KontoTerminal::createTable(string name, const vector<KontoCDef>& defs) {
+void KontoTerminal::showBufferStats() {
+    BufStats stats = BufPageManager::getInstance().getStats();
+    BufFileStats& total = stats.total;
+    long long accesses = total.hits + total.misses;
+    std::ostringstream ratio, seconds;
+    ratio << std::fixed << std::setprecision(2) << (accesses ? 100.0 * total.hits / accesses : 0.0) << "%";
+    seconds << std::fixed << std::setprecision(3) << stats.ioSeconds << "s";
+    PT(1, "[BUFFER]");
+    cout << TABS[2] << "Pages: " << stats.capacity << ", shards: " << stats.shards
+        << ", dirty: " << stats.dirty << endl;
+    cout << TABS[2] << "Hits: " << total.hits << ", misses: " << total.misses
+        << ", hit ratio: " << ratio.str() << endl;
+    cout << TABS[2] << "Evictions: " << total.evictions << " (" << total.writeBacks << " dirty)"
+        << ", prefetched: " << total.prefetched << ", background writes: " << stats.flushed << endl;
+    cout << TABS[2] << "I/O: " << total.reads << " pages read, " << total.writes << " pages written, "
+        << seconds.str() << endl;
+    PT(1, "[FILES]");
+    cout << TABS[2] << "|" << SS(30, "FILE") << "|" << SS(10, "HITS") << "|" << SS(10, "MISSES") << "|"
+        << SS(10, "PREFETCH") << "|" << SS(10, "EVICTED") << "|" << SS(10, "READS") << "|"
+        << SS(10, "WRITES") << "|" << endl;
+    for (auto& item : stats.files) {
+        const BufFileStats& file = item.second;
+        if (file.hits + file.misses + file.prefetched + file.reads + file.writes == 0) continue;
+        cout << TABS[2] << "|" << SS(30, item.first) << "|" << SS(10, to_string(file.hits), true) << "|"
+            << SS(10, to_string(file.misses), true) << "|" << SS(10, to_string(file.prefetched), true) << "|"
+            << SS(10, to_string(file.evictions), true) << "|" << SS(10, to_string(file.reads), true) << "|"
+            << SS(10, to_string(file.writes), true) << "|" << endl;
+    }
+}
+
+void KontoTerminal::createTable(string name, const vector<KontoCDef>& defs, bool compressed, bool pax, bool slotted) {
     if (currentDatabase == "") {PT(1, "Error: Not using a database!");return;}
     if (hasTable(name)) {PT(1, "Error: Table already exists."); return;}
+    uint recordSize = 8;
+    for (auto& def : defs) recordSize += def.size;
+    if (pax && slotted) {PT(1, "Error: PAX and slotted layouts cannot be combined."); return;}
+    if (KontoTableFile::getSlotsPerPage(recordSize, BufPageManager::getInstance().getPageSize(), slotted) == 0) {
+        PT(1, "Error: Record size " + to_string(recordSize) + " exceeds the page size.");
+        return;
+    }
     KontoTableFile* handle; 
-    KontoTableFile::createFile(currentDatabase + "/" + name, &handle);
+    KontoTableFile::createFile(currentDatabase + "/" + name, &handle, compressed, pax, slotted);
     for (auto& def : defs) {
         KontoCDef copy = def;
         handle->defineField(copy);
@@ -316,6 +407,7 @@ void KontoTerminal::dropTable(string name) {
     }
     if (!flag) {PT(1, "Error: No such table!"); return;}
     KontoTableFile* handle; 
+    unloadTables();
     KontoTableFile::loadFile(currentDatabase + "/" + name, &handle);
     handle->drop();
     save_lines(currentDatabase, get_filename(TABLES_FILE), tables);
@@ -326,13 +418,60 @@ bool KontoTerminal::hasTable(string table) {
     return false;
 }
 
+KontoResult KontoTerminal::loadTable(string table, KontoTableFile** handle) {
+    string filename = currentDatabase + "/" + table;
+    auto iter = openedTables.find(filename);
+    if (iter != openedTables.end()) {
+        iter->second.lastUsed = ++tableClock;
+        *handle = iter->second.handle; 
+        return KR_OK;
+    }
+    KontoResult res = KontoTableFile::loadFile(filename, handle);
+    if (res == KR_OK) openedTables[filename] = KontoTableCache{*handle, ++tableClock};
+    return res;
+}
+
+void KontoTerminal::unloadTable(string table) {
+    auto iter = openedTables.find(currentDatabase + "/" + table);
+    if (iter == openedTables.end()) return;
+    iter->second.handle->close();
+    delete iter->second.handle;
+    openedTables.erase(iter);
+}
+
+void KontoTerminal::unloadTables() {
+    for (auto& item : openedTables) {
+        item.second.handle->close();
+        delete item.second.handle;
+    }
+    openedTables.clear();
+}
+
+void KontoTerminal::trimTables() {
+    while (openedTables.size() > MAX_CACHED_TABLES) {
+        auto victim = openedTables.begin();
+        for (auto iter = openedTables.begin(); iter != openedTables.end(); iter++) 
+            if (iter->second.lastUsed < victim->second.lastUsed) victim = iter;
+        victim->second.handle->close();
+        delete victim->second.handle;
+        openedTables.erase(victim);
+    }
+}
+
+void KontoTerminal::flushTables() {
+    for (auto& item : openedTables) item.second.handle->flushMeta();
+}
+
 void KontoTerminal::showTable(string name) {
     if (currentDatabase == "") {PT(1, "Error: Not using a database!");return;}
     if (!hasTable(name)) {PT(1, "Error: No such table!"); return;}
     KontoTableFile* handle; 
-    KontoTableFile::loadFile(currentDatabase + "/" + name, &handle);
+    loadTable(name, &handle);
     PT(1, "[TABLE " + name + "]");
     cout << TABS[2] << "Records count: " << handle->recordCount << endl;
+    if (handle->isCompressed()) PT(2, "Compressed pages.");
+    if (handle->isPax()) PT(2, "PAX page layout.");
+    if (handle->isSlotted()) PT(2, "Slotted pages with variable-length strings.");
     PT(1, "[COLUMNS]");
     cout << TABS[2] << "|" << SS(20, "NAME") << "|" << SS(10, "TYPE") << "|" <<
         SS(10, "NULLABLE") << "|" <<
@@ -389,13 +528,27 @@ void KontoTerminal::showTable(string name) {
         cout << ")" << endl;
     }
     if (!hasIndex) PT(2, "No indices created."); 
+}
+
+void KontoTerminal::vacuumTable(string name) {
+    if (currentDatabase == "") {PT(1, "Error: Not using a database!");return;}
+    if (!hasTable(name)) {PT(1, "Error: No such table!"); return;}
+    KontoTableFile* handle; 
+    unloadTable(name);
+    KontoTableFile::loadFile(currentDatabase + "/" + name, &handle);
+    uint removed; long long reclaimed;
+    handle->vacuum(removed, reclaimed);
     handle->close();
+    delete handle;
+    PT(1, "Vacuum " + name + ": " + to_string(removed) + " deleted rows removed, "
+        + to_string(reclaimed) + " bytes reclaimed.");
 }
 
 void KontoTerminal::alterAddPrimaryKey(string table, const vector<string>& cols) {
     if (currentDatabase == "") {PT(1, "Error: Not using a database!");return;}
     if (!hasTable(table)) {PT(1, "Error: No such table!"); return;}
     KontoTableFile* handle; 
+    unloadTable(table);
     KontoTableFile::loadFile(currentDatabase + "/" + table, &handle);
     vector<uint> id; id.clear();
     KontoResult res;
@@ -410,6 +563,8 @@ void KontoTerminal::alterAddPrimaryKey(string table, const vector<string>& cols)
     }
     res = handle->alterAddPrimaryKey(id);
     if (res==KR_REPETITION) {err("primary key: Cannot create primary key for there are repetitions.");}
+    if (res==KR_META_FULL) {err("primary key: Too many columns to fit in the table meta page.");}
+    if (res==KR_KEY_TOO_LONG) {err("primary key: Key is too long for the page size.");}
     handle->close();
 }
 
@@ -417,6 +572,7 @@ void KontoTerminal::alterDropPrimaryKey(string table) {
     if (currentDatabase == "") {PT(1, "Error: Not using a database!");return;}
     if (!hasTable(table)) {PT(1, "Error: No such table!"); return;}
     KontoTableFile* handle; 
+    unloadTable(table);
     KontoTableFile::loadFile(currentDatabase + "/" + table, &handle);
     handle->alterDropPrimaryKey();
     handle->close();
@@ -426,6 +582,7 @@ void KontoTerminal::alterAddColumn(string table, const KontoCDef& def) {
     if (currentDatabase == "") {PT(1, "Error: Not using a database!");return;}
     if (!hasTable(table)) {PT(1, "Error: No such table!"); return;}
     KontoTableFile* handle; 
+    unloadTable(table);
     KontoTableFile::loadFile(currentDatabase + "/" + table, &handle);
     handle->alterAddColumn(def);
     dropTableIndices(table); saveIndices();
@@ -436,6 +593,7 @@ void KontoTerminal::alterDropColumn(string table, string col) {
     if (currentDatabase == "") {PT(1, "Error: Not using a database!");return;}
     if (!hasTable(table)) {PT(1, "Error: No such table!"); return;}
     KontoTableFile* handle; 
+    unloadTable(table);
     KontoTableFile::loadFile(currentDatabase + "/" + table, &handle);
     auto res = handle->alterDropColumn(col);
     if (res==KR_NO_SUCH_COLUMN) {
@@ -451,6 +609,7 @@ void KontoTerminal::alterChangeColumn(string table, string original, const Konto
     if (currentDatabase == "") {PT(1, "Error: Not using a database!");return;}
     if (!hasTable(table)) {PT(1, "Error: No such table!"); return;}
     KontoTableFile* handle; 
+    unloadTable(table);
     KontoTableFile::loadFile(currentDatabase + "/" + table, &handle);
     auto res = handle->alterChangeColumn(original, newdef);
     if (res==KR_NO_SUCH_COLUMN) {
@@ -470,6 +629,7 @@ void KontoTerminal::alterAddForeignKey(string table, string fkname,
     if (currentDatabase == "") {PT(1, "Error: Not using a database!");return;}
     if (!hasTable(table)) {PT(1, "Error: No such table!"); return;}
     KontoTableFile* handle; 
+    unloadTable(table);
     KontoTableFile::loadFile(currentDatabase + "/" + table, &handle);
     vector<uint> id; id.clear();
     if (fkname == "") {
@@ -485,7 +645,8 @@ void KontoTerminal::alterAddForeignKey(string table, string fkname,
         }
         id.push_back(p);
     }
-    handle->alterAddForeignKey(fkname, id, foreignTable, foreignNames);
+    KontoResult res = handle->alterAddForeignKey(fkname, id, foreignTable, foreignNames);
+    if (res==KR_META_FULL) err("foreign key: Not enough space left in the table meta page for " + fkname + ".");
     handle->close();
 }
 
@@ -493,6 +654,7 @@ void KontoTerminal::alterDropForeignKey(string table, string fkname) {
     if (currentDatabase == "") {PT(1, "Error: Not using a database!");return;}
     if (!hasTable(table)) {PT(1, "Error: No such table!"); return;}
     KontoTableFile* handle; 
+    unloadTable(table);
     KontoTableFile::loadFile(currentDatabase + "/" + table, &handle);
     auto res = handle->alterDropForeignKey(fkname);
     if (res==KR_NO_SUCH_FOREIGN) err("Drop foreign: No such foreign key!");
@@ -519,7 +681,7 @@ ProcessStatementResult KontoTerminal::processInsert(string tbname) {
     if (currentDatabase == "") {PT(1, "Error: Not using a database!");return PSR_ERR;}
     if (!hasTable(tbname)) return err("Error: No such table!");
     KontoTableFile* handle; 
-    KontoTableFile::loadFile(currentDatabase + "/" + tbname, &handle);
+    loadTable(tbname, &handle);
     char* buffer = new char[handle->getRecordSize()];
     Token cur = lexer.peek();
     int line = 0;
@@ -532,7 +694,7 @@ ProcessStatementResult KontoTerminal::processInsert(string tbname) {
             line++;
             bool error = false;
             Token cur = lexer.nextToken();
-            ASSERTERR_CLOSE(cur, TK_LPAREN, "insert values: Expect Lparen.");
+            ASSERTERR(cur, TK_LPAREN, "insert values: Expect Lparen.");
             int n = handle->keys.size();
             for (int i=0;i<n;i++) {
                 const auto& key = handle->keys[i];
@@ -591,7 +753,7 @@ ProcessStatementResult KontoTerminal::processInsert(string tbname) {
         }
     } else {
         cur = lexer.nextToken(); cur = lexer.nextToken(TE_STRING_VALUE);
-        ASSERTERR_CLOSE(cur, TK_STRING_VALUE, "insert from file: Expect filename string.");
+        ASSERTERR(cur, TK_STRING_VALUE, "insert from file: Expect filename string.");
         int insertedCount = 0;
         std::ifstream fin(cur.identifier);
         int line = 0;
@@ -670,7 +832,6 @@ ProcessStatementResult KontoTerminal::processInsert(string tbname) {
         fin.close();
     }
     delete[] buffer;
-    handle->close();
     return PSR_OK;
 }
 
@@ -712,6 +873,7 @@ void KontoTerminal::createIndex(string idname, string table, const vector<string
     if (currentDatabase == "") {PT(1, "Error: Not using a database!");return;}
     if (!hasTable(table)) {PT(1,"Error: No such table!"); return;}
     KontoTableFile* handle; 
+    unloadTable(table);
     KontoTableFile::loadFile(currentDatabase + "/" + table, &handle);
     vector<uint> colids; colids.clear();
     KontoResult res;
@@ -727,6 +889,11 @@ void KontoTerminal::createIndex(string idname, string table, const vector<string
         handle->close();
         return;
     }
+    if (res == KR_KEY_TOO_LONG) {
+        PT(1, "Error: Index key is too long for the page size.");
+        handle->close();
+        return;
+    }
     KontoIndexDesc desc{
         .name = idname,
         .table = table,
@@ -745,6 +912,7 @@ void KontoTerminal::dropIndex(string idname, string table) {
         if (indices[i].name == idname && (table=="" || table==indices[i].table)) {ptr = &indices[i]; position = i; break;}
     if (ptr==nullptr) {PT(1, "Error: No such index!"); return;}
     KontoTableFile* handle; 
+    unloadTable(ptr->table);
     KontoTableFile::loadFile(currentDatabase + "/" + ptr->table, &handle);
     handle->dropIndex(ptr->cols);
     handle->close();
@@ -760,9 +928,8 @@ void KontoTerminal::debugIndex(string idname) {
     for (int i=0; i<n; i++) if (indices[i].name == idname) {ptr = &indices[i]; position = i; break;}
     if (ptr==nullptr) {PT(1, "Error: No such index!"); return;}
     KontoTableFile* handle; 
-    KontoTableFile::loadFile(currentDatabase + "/" + ptr->table, &handle);
+    loadTable(ptr->table, &handle);
     handle->debugIndex(ptr->cols);
-    handle->close();
 }
 
 void KontoTerminal::debugIndex() {
@@ -783,30 +950,27 @@ void KontoTerminal::debugTable(string tbname) {
     if (currentDatabase == "") {PT(1, "Error: Not using a database!");return;}
     if (!hasTable(tbname)) {PT(1,"Error: No such table!"); return;}
     KontoTableFile* handle; 
-    KontoTableFile::loadFile(currentDatabase + "/" + tbname, &handle);
+    loadTable(tbname, &handle);
     handle->printTable(true, true);
-    handle->close();
 }
 
 void KontoTerminal::debugPrimary(string tbname) {
     if (currentDatabase == "") {PT(1, "Error: Not using a database!");return;}
     if (!hasTable(tbname)) {PT(1,"Error: No such table!"); return;}
     KontoTableFile* handle; 
-    KontoTableFile::loadFile(currentDatabase + "/" + tbname, &handle);
+    loadTable(tbname, &handle);
     KontoIndex* index = handle->getPrimaryIndex();
     if (index==nullptr) {PT(1,"Error: This table has no primary index."); return;};
     index->debugPrint();
-    handle->close();
 }
 
 uint KontoTerminal::getColumnIndex(string table, string col, KontoKeyType& type) {
     if (!hasTable(table)) return -1;
     KontoTableFile* handle; 
-    KontoTableFile::loadFile(currentDatabase + "/" + table, &handle);
+    loadTable(table, &handle);
     uint ret;
     KontoResult res = handle->getKeyIndex(col.c_str(), ret);
     if (res == KR_OK) type = handle->keys[ret].type;
-    handle->close();
     if (res == KR_OK) return ret;
     else return -1;
 } 
@@ -991,7 +1155,7 @@ KontoQRes KontoTerminal::queryWhere(const KontoWhere& where) {
     assert(where.type != WT_CROSS);
     KontoTableFile* handle; 
     KontoQRes ret, tmp;
-    KontoTableFile::loadFile(currentDatabase + "/" + where.ltable, &handle);
+    loadTable(where.ltable, &handle);
     if (where.type != WT_INNER) {
         vector<uint> list = single_uint_vector(where.lid);
         KontoIndex* index = handle->getIndex(list);
@@ -1048,64 +1212,21 @@ KontoQRes KontoTerminal::queryWhere(const KontoWhere& where) {
             delete[] lbuffer;
         } else {
             //cout << "using iterator to query" << endl;
-            KontoQRes q; handle->allEntries(q);
-            if (where.op < OP_DOUBLE) {
-                switch (where.keytype) {
-                    case KT_INT: {
-                        int vi = where.rvalue.value;
-                        handle->queryEntryInt(q, where.lid, where.op, vi, ret);
-                        break;
-                    }
-                    case KT_FLOAT: {
-                        double vd = where.rvalue.doubleValue;
-                        handle->queryEntryFloat(q, where.lid, where.op, vd, ret);
-                        break;
-                    }
-                    case KT_STRING: {
-                        const char* vs = where.rvalue.identifier.c_str();
-                        handle->queryEntryString(q, where.lid, where.op, vs, ret);
-                        break;
-                    }
-                    case KT_DATE: {
-                        Date vd = where.rvalue.value;
-                        handle->queryEntryDate(q, where.lid, where.op, vd, ret);
-                        break;
-                    }
-                    default:
-                        assert(false);
-                }
-            } else {
-                switch (where.keytype) {
-                    case KT_INT: {
-                        int vir = where.rvalue.value, vil = where.lvalue.value;
-                        handle->queryEntryInt(q, where.lid, where.op, vil, vir, ret);
-                        break;
-                    }
-                    case KT_FLOAT: {
-                        double vdr = where.rvalue.doubleValue, vdl = where.lvalue.doubleValue;
-                        handle->queryEntryFloat(q, where.lid, where.op, vdl, vdr, ret);
-                        break;
-                    }
-                    case KT_STRING: {
-                        const char* vsr = where.rvalue.identifier.c_str(), *vsl = where.lvalue.identifier.c_str();
-                        handle->queryEntryString(q, where.lid, where.op, vsl, vsr, ret);
-                        break;
-                    }
-                    case KT_DATE: {
-                        Date vdr = where.rvalue.value, vdl = where.lvalue.value;
-                        handle->queryEntryDate(q, where.lid, where.op, vdl, vdr, ret);
-                        break;
-                    }
-                    default:
-                        assert(false);
-                }
-            }
+            ret = queryWhereScan(handle, where);
         }
     } else {
-        KontoQRes q; handle->allEntries(q);
-        handle->queryCompare(q, where.lid, where.rid, where.op, ret);
+        ret = queryWhereScan(handle, where);
     }
-    handle->close();
+    return ret;
+}
+
+KontoQRes KontoTerminal::queryWhereScan(KontoTableFile* handle, const KontoWhere& where) {
+    // 逐批取出记录位置并立即过滤，不必先列出全表的位置
+    KontoQRes ret, batch;
+    KontoScanCursor cursor; handle->openScan(cursor);
+    while (handle->nextScanBatch(cursor, batch))
+        ret.extend(queryWhereWithin(batch, where));
+    handle->closeScan(cursor);
     return ret;
 }
 
@@ -1113,7 +1234,7 @@ KontoQRes KontoTerminal::queryWhereWithin(const KontoQRes& prev, const KontoWher
     assert(where.type != WT_CROSS);
     KontoTableFile* handle; 
     KontoQRes ret, tmp;
-    KontoTableFile::loadFile(currentDatabase + "/" + where.ltable, &handle);
+    loadTable(where.ltable, &handle);
     if (where.type != WT_INNER) {
         const KontoQRes& q = prev;
         if (where.op < OP_DOUBLE) {
@@ -1170,7 +1291,6 @@ KontoQRes KontoTerminal::queryWhereWithin(const KontoQRes& prev, const KontoWher
     } else {
         handle->queryCompare(prev, where.lid, where.rid, where.op, ret);
     }
-    handle->close();
     return ret;
 }
 
@@ -1180,7 +1300,7 @@ void KontoTerminal::queryWheres(const vector<KontoWhere>& wheres, KontoQRes& out
     string table = wheres[0].ltable;
     for (int i=1;i<wheres.size();i++) assert(wheres[i].ltable == table);
     KontoTableFile* handle;
-    KontoTableFile::loadFile(currentDatabase + "/" + table, &handle);
+    loadTable(table, &handle);
     int first = 0; bool found = false;
     for (int i=0;i<wheres.size();i++) {
         if (wheres[i].type == WT_CONST && wheres[i].op >= OP_DOUBLE) {
@@ -1196,7 +1316,6 @@ void KontoTerminal::queryWheres(const vector<KontoWhere>& wheres, KontoQRes& out
             }
         }
     }
-    handle->close();
     out = queryWhere(wheres[first]);
     for (int i=0;i<wheres.size();i++) {
         if (i!=first) out = queryWhereWithin(out, wheres[i]);
@@ -1236,11 +1355,10 @@ void KontoTerminal::queryWheresFrom(const vector<KontoWhere>& wheres, const vect
         for (int j=0;j<tables.size();j++) {if (tables[j]==givenTables[i]) {results.push_back(temp[j]); flag = true; break;}}
         if (!flag) {
             KontoTableFile* handle;
-            KontoTableFile::loadFile(currentDatabase + "/" + givenTables[i], &handle);
+            loadTable(givenTables[i], &handle);
             KontoQRes q;
             handle->allEntries(q);
             results.push_back(q);
-            handle->close();
         }
     }
 }
@@ -1251,9 +1369,8 @@ void KontoTerminal::deletes(string tbname, const vector<KontoWhere>& wheres) {
     for (auto& item: wheres) assert(item.type != WT_CROSS);
     KontoQRes q; queryWheres(wheres, q);
     KontoTableFile* handle;
-    KontoTableFile::loadFile(currentDatabase + "/" + tbname, &handle);
+    loadTable(tbname, &handle);
     handle->deletes(q);
-    handle->close();
 }
 
 void KontoTerminal::debugFrom(string tbname, const vector<KontoWhere>& wheres) {
@@ -1261,9 +1378,8 @@ void KontoTerminal::debugFrom(string tbname, const vector<KontoWhere>& wheres) {
     for (auto& item: wheres) assert(item.type != WT_CROSS);
     KontoQRes q; queryWheres(wheres, q);
     KontoTableFile* handle;
-    KontoTableFile::loadFile(currentDatabase + "/" + tbname, &handle);
+    loadTable(tbname, &handle);
     handle->printTable(q, true);
-    handle->close();
 }
 
 ProcessStatementResult KontoTerminal::processSelect() {
@@ -1312,6 +1428,8 @@ ProcessStatementResult KontoTerminal::processSelect() {
     //printWheres(wheres);
     uint nTables = fromTables.size();
     queryWheresFrom(wheres, fromTables, lists);
+    // 下面按编号取各表的结果
+    for (auto& list: lists) list.expand();
     for (int i=0;i<nTables;i++) if (lists[i].size()==0) {
         cout << TABS[1] << "The result is empty table." << endl;
         return PSR_OK;
@@ -1319,7 +1437,7 @@ ProcessStatementResult KontoTerminal::processSelect() {
     typedef KontoTableFile* KontoTableFilePtr;
     KontoTableFilePtr tables[nTables];
     for (int i=0;i<nTables;i++) 
-        KontoTableFile::loadFile(currentDatabase + "/" + fromTables[i], &tables[i]);
+        loadTable(fromTables[i], &tables[i]);
     vector<uint> selectedTables; // the selected columns' table, indicated by index
     vector<uint> selectedKids;   // the selected columns, indicated by index
     KontoTableFile* tempTable;
@@ -1337,7 +1455,6 @@ ProcessStatementResult KontoTerminal::processSelect() {
                 }
             }
             if (!flag) {
-                for (auto& ptr : tables) ptr->close();
                 return err("select: no such column called " + target);
             }
         } else {
@@ -1346,7 +1463,6 @@ ProcessStatementResult KontoTerminal::processSelect() {
                 uint kid; 
                 KontoResult result = tables[j]->getKeyIndex(selectedColumns[i].c_str(), kid);
                 if (result != KR_OK) {
-                    for (auto& ptr : tables) ptr->close();
                     return err("select: no such column called " + selectedColumns[i] + " in " + selectedColumnTables[i]);
                 }
                 selectedTables.push_back(j); selectedKids.push_back(kid);
@@ -1439,7 +1555,7 @@ ProcessStatementResult KontoTerminal::processSelect() {
         //cout << "iterators: "; for (int i=0;i<nTables;i++) cout << iterators[i] << " "; cout << endl;
     }
     for (int i=0;i<nTables;i++) {
-        tables[i]->close(); delete[] buffers[i];
+        delete[] buffers[i];
     }
     tempTable->printTable(false, false);
     tempTable->drop();
@@ -1493,9 +1609,9 @@ void KontoTerminal::printWheres(const vector<KontoWhere>& wheres) {
 
 void KontoTerminal::printQRes(const KontoQRes& qres) {
     cout << "[qres] count = " << qres.size() << endl;
-    int n = qres.size();
-    for (int i=0;i<n;i++) 
-        cout << TABS[1] << "[" << i << "] @ (" << qres.get(i).page << "," << qres.get(i).id << ")" << endl;
+    int i = 0;
+    for (auto& pos: qres) 
+        cout << TABS[1] << "[" << i++ << "] @ (" << pos.page << "," << pos.id << ")" << endl;
 }
 
 TokenExpectation KontoTerminal::valueTypeToExpectation(KontoKeyType type) {
@@ -1516,31 +1632,31 @@ ProcessStatementResult KontoTerminal::processUpdate(string tbname) {
     Token cur = lexer.nextToken(), peek;
     ASSERTERR(cur, TK_SET, "update: Expect keyword SET.");
     KontoTableFile* handle; 
-    KontoTableFile::loadFile(currentDatabase + "/" + tbname, &handle);
+    loadTable(tbname, &handle);
     while (true) {
         cur = lexer.nextToken(TE_IDENTIFIER);
-        ASSERTERR_CLOSE(cur, TK_IDENTIFIER, "update set: Expect identifier.");
+        ASSERTERR(cur, TK_IDENTIFIER, "update set: Expect identifier.");
         peek = lexer.peek();
         if (peek.tokenKind == TK_DOT) {
-            if (cur.identifier != tbname) {handle->close(); return err("update set: column table name is not " + tbname);}
+            if (cur.identifier != tbname) {return err("update set: column table name is not " + tbname);}
             lexer.nextToken(); cur = lexer.nextToken(TE_IDENTIFIER);
-            ASSERTERR_CLOSE(cur, TK_IDENTIFIER, "update set: Expect identifier after dot.");
+            ASSERTERR(cur, TK_IDENTIFIER, "update set: Expect identifier after dot.");
         }
         uint kid;
         KontoResult res = handle->getKeyIndex(cur.identifier.c_str(), kid);
-        if (res != KR_OK) {handle->close(); return err("update set: no such column called " + cur.identifier);}
+        if (res != KR_OK) {return err("update set: no such column called " + cur.identifier);}
         kids.push_back(kid);
         cur = lexer.nextToken();
-        ASSERTERR_CLOSE(cur, TK_EQUAL, "update set: Expect equal symbol.");
+        ASSERTERR(cur, TK_EQUAL, "update set: Expect equal symbol.");
         cur = lexer.nextToken(valueTypeToExpectation(handle->keys[kid].type));
         switch (handle->keys[kid].type) {
-            case KT_INT: ASSERTERR_CLOSE(cur, TK_INT_VALUE, "update set: Expect int value."); break;
-            case KT_FLOAT: ASSERTERR_CLOSE(cur, TK_FLOAT_VALUE, "update set: Expect float value."); break;
-            case KT_STRING: ASSERTERR_CLOSE(cur, TK_STRING_VALUE, "update set: Expect string value."); break;
+            case KT_INT: ASSERTERR(cur, TK_INT_VALUE, "update set: Expect int value."); break;
+            case KT_FLOAT: ASSERTERR(cur, TK_FLOAT_VALUE, "update set: Expect float value."); break;
+            case KT_STRING: ASSERTERR(cur, TK_STRING_VALUE, "update set: Expect string value."); break;
             case KT_DATE: {
-                ASSERTERR_CLOSE(cur, TK_STRING_VALUE, "update set: Expect string value."); 
+                ASSERTERR(cur, TK_STRING_VALUE, "update set: Expect string value."); 
                 cur.tokenKind = TK_DATE_VALUE;
-                Date parsed; if (!parse_date(cur.identifier, parsed)) {handle->close(); return err("update set: not valid date string.");}
+                Date parsed; if (!parse_date(cur.identifier, parsed)) {return err("update set: not valid date string.");}
                 cur.value = parsed;
                 break;
             }
@@ -1549,22 +1665,22 @@ ProcessStatementResult KontoTerminal::processUpdate(string tbname) {
         values.push_back(cur);
         cur = lexer.nextToken();
         if (cur.tokenKind == TK_WHERE) break;
-        ASSERTERR_CLOSE(cur, TK_COMMA, "update set: Expect comma.");
+        ASSERTERR(cur, TK_COMMA, "update set: Expect comma.");
     }
-    handle->close();
     vector<KontoWhere> wheres; 
     ProcessStatementResult psr = processWheres(tbname, wheres);
     if (psr != PSR_OK) return psr;
     KontoQRes qres;
     //cout << "query wheres" << endl;
     queryWheres(wheres, qres);
+    qres.expand();
     //cout << "updating " << endl;
-    KontoTableFile::loadFile(currentDatabase + "/" + tbname, &handle);
     int nQuery = qres.size();
     int nSet = values.size();
     char buffer[handle->getRecordSize()];
     for (int i=0;i<nQuery;i++) {
-        const auto& pos = qres.get(i);
+        // 变长记录的表中字符串变长时记录可能移到其他页，pos 随之更新
+        KontoRPos pos = qres.get(i);
         handle->deleteIndex(pos);
         KontoResult res;
         for (int j=0;j<nSet;j++) {
@@ -1586,7 +1702,7 @@ ProcessStatementResult KontoTerminal::processUpdate(string tbname) {
                     handle->getDataCopied(pos, buffer);
                     handle->setEntryString(buffer, kids[j], values[j].identifier.c_str());
                     res = handle->checkLegal(buffer, kids[j]);
-                    if (res==KR_OK) handle->editEntryString(pos, kids[j], values[j].identifier.c_str());
+                    if (res==KR_OK) handle->updateEntry(pos, buffer);
                     break;
                 case KT_DATE: 
                     handle->getDataCopied(pos, buffer);
@@ -1597,16 +1713,13 @@ ProcessStatementResult KontoTerminal::processUpdate(string tbname) {
             }
             //cout << "edit fin" << endl;
             if (res == KR_REPETITION) {
-                handle->close(); 
                 return err("Error: Primary key unique constraint failed.");
             } else if (res == KR_FOREIGN_KEY_FAIL) {
-                handle->close();
                 return err("Error: Foreign key check failed.");
             }
         }
         handle->insertIndex(pos);
     }
-    handle->close();
     return PSR_OK;
 }
 
@@ -1829,7 +1942,17 @@ ProcessStatementResult KontoTerminal::processCreate(){
     if (peek.tokenKind == TK_DATABASE) {
         lexer.nextToken(); cur = lexer.nextToken(TE_IDENTIFIER);
         ASSERTERR(cur, TK_IDENTIFIER, "create database: Expect identifier.");
-        createDatabase(cur.identifier);
+        string dbname = cur.identifier;
+        int pageSize = PAGE_SIZE;
+        if (lexer.peek().tokenKind == TK_PAGESIZE) {
+            lexer.nextToken(); cur = lexer.nextToken();
+            ASSERTERR(cur, TK_INT_VALUE, "create database - pagesize: Expect int value.");
+            pageSize = cur.value;
+            if (pageSize < MIN_PAGE_SIZE || pageSize > MAX_PAGE_SIZE || (pageSize & (pageSize - 1)))
+                return err("create database - pagesize: Expect a power of 2 between "
+                    + to_string(MIN_PAGE_SIZE) + " and " + to_string(MAX_PAGE_SIZE) + ".");
+        }
+        createDatabase(dbname, pageSize);
         return PSR_OK;
     } else if (peek.tokenKind == TK_INDEX) {
         if (currentDatabase == "") return err("create table: Not using a database!");
@@ -1997,7 +2120,23 @@ ProcessStatementResult KontoTerminal::processCreate(){
         // finish analyse keylist
         cur = lexer.nextToken();
         ASSERTERR(cur, TK_RPAREN, "create table: Expect RParen.");
-        createTable(name, defs);
+        bool compressed = false, pax = false, slotted = false;
+        while (true) {
+            peek = lexer.peek();
+            if (peek.tokenKind == TK_COMPRESSED && !compressed) compressed = true;
+            else if (peek.tokenKind == TK_PAX && !pax) pax = true;
+            else if (peek.tokenKind == TK_SLOTTED && !slotted) slotted = true;
+            else break;
+            lexer.nextToken();
+        }
+        // 主键过宽时整条建表语句失败，而不是建出一张没有主键的表
+        uint primarySize = 0;
+        for (auto& def : defs) 
+            for (auto& item : primaries) if (def.name == item) primarySize += def.size;
+        if (primaries.size() > 0 && !KontoIndex::keyFits(primarySize, BufPageManager::getInstance().getPageSize()))
+            return err("create table: Primary key is too long for the page size.");
+        createTable(name, defs, compressed, pax, slotted);
+        if (!hasTable(name)) return PSR_ERR;
         alterAddPrimaryKey(name, primaries);
         //cout << "foreigns = " << foreigns.size() << endl;
         for (int i=0;i<foreigns.size();i++)
@@ -2099,6 +2238,7 @@ void KontoTerminal::alterRenameColumn(string table, string origname, string newn
     if (currentDatabase == "") {PT(1, "Error: Not using a database!");return;}
     if (!hasTable(table)) {PT(1, "Error: No such table!"); return;}
     KontoTableFile* handle; 
+    unloadTable(table);
     KontoTableFile::loadFile(currentDatabase + "/" + table, &handle);
     auto res = handle->alterRenameColumn(origname, newname);
     if (res == KR_NO_SUCH_COLUMN) {
@@ -2117,8 +2257,10 @@ void KontoTerminal::alterRenameTable(string table, string newname) {
     for (int i=0;i<tables.size();i++) if (tables[i]==table) tables[i]=newname;
     for (auto& id: indices) if (id.table == table) id.table = newname;
     KontoTableFile* handle;
+    unloadTables();
     KontoTableFile::loadFile(currentDatabase + "/" + table, &handle);
     handle->alterRename(currentDatabase + "/" + newname);
+    handle->close();
     save_lines(currentDatabase, get_filename(TABLES_FILE), tables);
     saveIndices();
 }
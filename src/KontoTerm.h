@@ -4,6 +4,7 @@
 #include "KontoConst.h"
 #include "KontoRecord.h"
 #include "KontoLexer.h"
+#include <map>
 
 /* SUPPORTED COMMANDS 
 
@@ -20,9 +21,9 @@ alter table [tbname] change [colname] [typedef]
 alter table [tbname] rename [col] to [col]
 alter table [tbname] rename to [newtbname]
 
-create database [dbname]
+create database [dbname] [pagesize [bytes]]
 create index [idname] on [tbname] (cols...)
-create table [tbname] (coldefs...)
+create table [tbname] (coldefs...) [compressed] [pax|slotted]
 
 debug echo [message]
 debug echo 
@@ -49,6 +50,9 @@ quit
 
 select [* or cols] from [tables...] where [wheres...]
 
+reset buffer stats
+
+show buffer stats
 show database [dbname]
 show databases
 show table [tbname]
@@ -59,10 +63,16 @@ update [tbname] set [setstmt] where [wheres...]
 use [dbname]
 use database [dbname]
 
+vacuum
+vacuum [tbname]
+
 */
 
 const string TABLES_FILE = "__tables";
 const string INDICES_FILE = "__indices";
+const string PAGESIZE_FILE = "__pagesize";
+// 语句之间保留的表句柄数上限。
+const int MAX_CACHED_TABLES = 16;
 
 // 语句语法分析结果。
 enum ProcessStatementResult {
@@ -96,12 +106,21 @@ struct KontoWhere {
     uint lid, rid;
 };
 
+// 缓存的表句柄及其最近使用时刻。
+struct KontoTableCache {
+    KontoTableFile* handle;
+    int lastUsed;
+};
+
 // 用户终端，采用 Singleton 模式。
 class KontoTerminal {
 private:
     string currentDatabase;
     vector<string> tables;
     vector<KontoIndexDesc> indices;
+    // 已打开的表句柄，以表文件路径为键，跨语句复用。
+    std::map<string, KontoTableCache> openedTables;
+    int tableClock;
     KontoTerminal();
     static KontoTerminal* instancePtr;
     bool commandLine;
@@ -111,8 +130,25 @@ public:
     static KontoTerminal* getInstance();
     // 判断某表是否存在。
     bool hasTable(string table);
-    // 创建数据库。
-    void createDatabase(string dbname);
+    /** 获取当前数据库中某表的句柄。句柄由终端缓存并复用，调用者不应关闭。
+     * @param table 表名。
+     * @param handle 返回表句柄。
+     * */
+    KontoResult loadTable(string table, KontoTableFile** handle);
+    /** 关闭某表的缓存句柄。修改表结构的语句须在自行打开该表之前调用。
+     * @param table 表名。
+     * */
+    void unloadTable(string table);
+    // 关闭所有缓存的表句柄。
+    void unloadTables();
+    // 关闭最久未使用的表句柄，直至缓存数不超过 MAX_CACHED_TABLES。仅在语句之间调用。
+    void trimTables();
+    // 将缓存的表句柄中尚未写回的元信息写回元信息页。
+    void flushTables();
+    // 创建数据库，页大小记录在数据库目录中。
+    void createDatabase(string dbname, int pageSize = PAGE_SIZE);
+    // 读取数据库的页大小。
+    int getPageSize(string dbname);
     // 使用数据库。
     void useDatabase(string dbname);
     // 删除数据库。
@@ -121,15 +157,22 @@ public:
     void showDatabase(string dbname);
     // 显示所有可用数据库。
     void showDatabases();
+    // 显示缓存统计：命中率、换出、后台写回与各文件的读写页数。
+    void showBufferStats();
     /** 创建数据表。
      * @param name 表名
      * @param defs 列定义。
+     * @param compressed 是否压缩存储。
+     * @param pax 数据页是否采用 PAX 布局。
+     * @param slotted 数据页是否为变长记录的槽页。
      * */
-    void createTable(string name, const vector<KontoCDef>& defs);
+    void createTable(string name, const vector<KontoCDef>& defs, bool compressed = false, bool pax = false, bool slotted = false);
     // 删除表。
     void dropTable(string name);
     // 显示表元数据。
     void showTable(string name);
+    // 整理表文件，去掉已删除的记录并重建索引。
+    void vacuumTable(string name);
     /** 添加主键。
      * @param table 表名。
      * @param cols 主键各列名。
@@ -213,6 +256,11 @@ public:
      * @param where where子句项，不能是WT_CROSS类型（即不能是跨表比较）。
      * */
     KontoQRes queryWhereWithin(const KontoQRes& prev, const KontoWhere& where);
+    /** 没有可用索引时，用顺序扫描游标逐批过滤全表。
+     * @param handle 表。
+     * @param where where子句项，不能是WT_CROSS类型。
+     * */
+    KontoQRes queryWhereScan(KontoTableFile* handle, const KontoWhere& where);
     /** 单表查询。
      * @param wheres 多个where子句项的列表，且它们都是对同一个表的单表查询。
      * @param out 返回查询结果
@@ -0,0 +1,191 @@
+#ifndef __PAGE_CODEC_H__
+#define __PAGE_CODEC_H__
+
+#include "constants.h"
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+
+/* 页面压缩。压缩表的页面在缓存中保持原样，写回时压缩、读入时解压。
+ * 压缩后的页面仍位于文件中原来的位置，以一个 16 字节的头部开始，只写入覆盖数据的
+ * 若干 PAGE_COMPRESS_BLOCK 字节块，页面其余部分由文件系统回收（打洞），
+ * 因而页号与文件偏移的对应不变，读写与文件占用的磁盘空间随压缩比减少。
+ * 压缩后不能少占一块的页面照原样写入，读入时以头部区分。
+ *
+ * 压缩格式为 LZ77 族：由若干序列组成，每个序列为一个标记字节（高 4 位为字面量长度，
+ * 低 4 位为匹配长度减 4，取 15 时后接扩展字节，每个 255 继续）、字面量、
+ * 2 字节的匹配距离与匹配长度的扩展字节。最后一个序列只有字面量。
+ * 定长字符串列补零的部分成为距离为 1 的长匹配。
+ */
+class PageCodec {
+private:
+    static const unsigned MAGIC = 0x47505a4b; // "KZPG"
+    static const int HASH_BITS = 12;
+    static const int MIN_MATCH = 4;
+
+    struct Header {
+        unsigned magic;
+        unsigned length;   // 压缩数据的字节数
+        unsigned check;    // length 取反，与 magic 一起避免将未压缩的页面误认为压缩页面
+        unsigned reserved;
+    };
+
+    static unsigned read32(const unsigned char *p) {
+        unsigned v;
+        memcpy(&v, p, 4);
+        return v;
+    }
+
+    static unsigned hash(const unsigned char *p) {
+        return (read32(p) * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    // 写入长度的扩展字节，空间不足时返回 nullptr。
+    static unsigned char *putLength(unsigned char *op, unsigned char *end, int len) {
+        for (; len >= 255; len -= 255) {
+            if (op >= end) return nullptr;
+            *op++ = 255;
+        }
+        if (op >= end) return nullptr;
+        *op++ = len;
+        return op;
+    }
+
+    static bool getLength(const unsigned char *&ip, const unsigned char *end, int &len) {
+        unsigned char b;
+        do {
+            if (ip >= end) return false;
+            b = *ip++;
+            len += b;
+        } while (b == 255);
+        return true;
+    }
+
+    // 写入一个序列：literals 个字面量，其后为距离 offset、长度 match 的匹配（match 为 0 时没有匹配）。
+    static unsigned char *putSequence(unsigned char *op, unsigned char *end,
+            const unsigned char *literal, int literals, int offset, int match) {
+        if (op >= end) return nullptr;
+        unsigned char *token = op++;
+        int extra = match > 0 ? match - MIN_MATCH : 0;
+        *token = (std::min(literals, 15) << 4) | std::min(extra, 15);
+        if (literals >= 15 && !(op = putLength(op, end, literals - 15))) return nullptr;
+        if (end - op < literals) return nullptr;
+        memcpy(op, literal, literals);
+        op += literals;
+        if (match == 0) return op;
+        if (end - op < 2) return nullptr;
+        *op++ = offset & 0xff;
+        *op++ = offset >> 8;
+        if (extra >= 15 && !(op = putLength(op, end, extra - 15))) return nullptr;
+        return op;
+    }
+
+public:
+    static const int HEADER_SIZE = sizeof(Header);
+
+    /** 压缩一段数据。
+     * @param src 原数据，不超过 MAX_PAGE_SIZE 字节。
+     * @param n 原数据的字节数。
+     * @param dst 输出缓冲区。
+     * @param cap 输出缓冲区的字节数。
+     * @return 压缩后的字节数，超过 cap 时返回 -1。
+     * */
+    static int compress(const char *src, int n, char *dst, int cap) {
+        const unsigned char *in = (const unsigned char*) src, *ip = in, *anchor = in;
+        const unsigned char *limit = in + n - MIN_MATCH;
+        unsigned char *op = (unsigned char*) dst, *end = op + cap;
+        unsigned table[1 << HASH_BITS]; // 位置加 1，0 表示空
+        memset(table, 0, sizeof(table));
+        while (ip <= limit) {
+            unsigned h = hash(ip), pos = table[h];
+            table[h] = ip - in + 1;
+            const unsigned char *ref = in + pos - 1;
+            if (pos == 0 || read32(ref) != read32(ip)) {
+                ip++;
+                continue;
+            }
+            const unsigned char *mp = ip + MIN_MATCH, *rp = ref + MIN_MATCH;
+            while (mp < in + n && *mp == *rp) mp++, rp++;
+            op = putSequence(op, end, anchor, ip - anchor, ip - ref, mp - ip);
+            if (op == nullptr) return -1;
+            ip = anchor = mp;
+        }
+        op = putSequence(op, end, anchor, in + n - anchor, 0, 0);
+        if (op == nullptr) return -1;
+        return op - (unsigned char*) dst;
+    }
+
+    /** 解压一段数据。
+     * @param src 压缩数据。
+     * @param n 压缩数据的字节数。
+     * @param dst 输出缓冲区。
+     * @param cap 输出缓冲区的字节数。
+     * @return 解压后的字节数，数据损坏时返回 -1。
+     * */
+    static int decompress(const char *src, int n, char *dst, int cap) {
+        const unsigned char *ip = (const unsigned char*) src, *end = ip + n;
+        unsigned char *out = (unsigned char*) dst, *op = out, *oend = out + cap;
+        while (ip < end) {
+            unsigned char token = *ip++;
+            int literals = token >> 4;
+            if (literals == 15 && !getLength(ip, end, literals)) return -1;
+            if (end - ip < literals || oend - op < literals) return -1;
+            memcpy(op, ip, literals);
+            ip += literals;
+            op += literals;
+            if (ip == end) break;
+            if (end - ip < 2) return -1;
+            int offset = ip[0] | (ip[1] << 8);
+            ip += 2;
+            int match = token & 15;
+            if (match == 15 && !getLength(ip, end, match)) return -1;
+            match += MIN_MATCH;
+            if (offset == 0 || offset > op - out || oend - op < match) return -1;
+            // 距离可能小于长度，须逐字节复制
+            const unsigned char *ref = op - offset;
+            for (int i = 0; i < match; i++) op[i] = ref[i];
+            op += match;
+        }
+        return op - out;
+    }
+
+    /** 将页面编码为写入文件的形式。
+     * @param page 原页面。
+     * @param size 页大小。
+     * @param out 输出缓冲区，一页大小。
+     * @param force 为真时只要压缩后不超过一页就采用压缩形式，用于文件的第 0 页。
+     * @return 需要写入的字节数，为 PAGE_COMPRESS_BLOCK 的倍数；不压缩时返回 -1，应照原样写入。
+     * */
+    static int encodePage(const char *page, int size, char *out, bool force) {
+        int limit = force ? size : size - PAGE_COMPRESS_BLOCK;
+        int len = compress(page, size, out + HEADER_SIZE, limit - HEADER_SIZE);
+        if (len < 0) return -1;
+        Header header = {MAGIC, (unsigned) len, ~(unsigned) len, 0};
+        memcpy(out, &header, HEADER_SIZE);
+        int stored = (HEADER_SIZE + len + PAGE_COMPRESS_BLOCK - 1) / PAGE_COMPRESS_BLOCK * PAGE_COMPRESS_BLOCK;
+        memset(out + HEADER_SIZE + len, 0, stored - HEADER_SIZE - len);
+        return stored;
+    }
+
+    // 判断文件中读出的页面是否为压缩形式。
+    static bool isEncoded(const char *buf) {
+        Header header;
+        memcpy(&header, buf, HEADER_SIZE);
+        return header.magic == MAGIC && header.check == ~header.length
+            && header.length <= MAX_PAGE_SIZE - HEADER_SIZE;
+    }
+
+    // 将文件中读出的页面原地还原，未压缩的页面不变。
+    static void decodePage(char *buf, int size) {
+        if (!isEncoded(buf)) return;
+        thread_local char scratch[MAX_PAGE_SIZE];
+        Header header;
+        memcpy(&header, buf, HEADER_SIZE);
+        assert((int) header.length <= size - HEADER_SIZE);
+        memcpy(scratch, buf + HEADER_SIZE, header.length);
+        int res = decompress(scratch, header.length, buf, size);
+        assert(res == size);
+    }
+};
+
+#endif
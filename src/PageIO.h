@@ -0,0 +1,240 @@
+#ifndef __PAGE_IO_H__
+#define __PAGE_IO_H__
+
+#include "constants.h"
+#include <cassert>
+#include <cerrno>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <climits>
+#include <vector>
+#include <linux/io_uring.h>
+
+// 一次页面读写，由 FileManager 根据文件编号与页号生成。读总是整页；压缩页面只写入 len 字节。
+struct PageRequest {
+    int fd;
+    off_t offset;
+    char *buf;
+    int fileID;
+    int len;
+};
+
+// 页面读写后端。批量接口在所有请求完成后返回；读到文件末尾之外的部分清零。
+// 请求宜按文件与偏移排序，相邻且连续的页面会被合并为一次向量读写。
+class PageIO {
+public:
+    virtual ~PageIO() {}
+
+    virtual void read(PageRequest *requests, int n) = 0;
+
+    virtual void write(PageRequest *requests, int n) = 0;
+
+    /** 创建读写后端。
+     * @param uring 是否优先使用 io_uring，不可用时退回 pread/pwrite。
+     * */
+    static PageIO *create(bool uring);
+
+protected:
+    // 返回从 i 开始、同一文件中偏移连续的一段请求的结尾，每段至多 IOV_MAX 页。
+    static int runEnd(PageRequest *requests, int n, int i) {
+        int j = i + 1;
+        while (j < n && j - i < IOV_MAX && requests[j].fd == requests[i].fd
+            && requests[j].offset == requests[j-1].offset + requests[j-1].len) j++;
+        return j;
+    }
+
+    // 一段连续的读只读到 done 字节时，将其后的部分清零。读入不完整只发生在文件末尾。
+    static void zeroTail(PageRequest *requests, int i, int j, ssize_t done) {
+        for (int k = i; k < j; k++) {
+            if (done < requests[k].len) memset(requests[k].buf + done, 0, requests[k].len - done);
+            done = std::max((ssize_t) 0, done - requests[k].len);
+        }
+    }
+
+    static ssize_t fillIovec(PageRequest *requests, int i, int j, iovec *iov) {
+        ssize_t bytes = 0;
+        for (int k = i; k < j; k++) {
+            iov[k-i].iov_base = requests[k].buf;
+            iov[k-i].iov_len = requests[k].len;
+            bytes += requests[k].len;
+        }
+        return bytes;
+    }
+};
+
+// 同步读写，连续的页面合并为一次 preadv/pwritev。
+class SyncPageIO : public PageIO {
+public:
+    void read(PageRequest *requests, int n) {
+        iovec iov[IOV_MAX];
+        for (int i = 0, j; i < n; i = j) {
+            j = runEnd(requests, n, i);
+            ssize_t bytes = fillIovec(requests, i, j, iov);
+            ssize_t res = preadv(requests[i].fd, iov, j - i, requests[i].offset);
+            assert(res >= 0);
+            if (res < bytes) zeroTail(requests, i, j, res);
+        }
+    }
+
+    void write(PageRequest *requests, int n) {
+        iovec iov[IOV_MAX];
+        for (int i = 0, j; i < n; i = j) {
+            j = runEnd(requests, n, i);
+            ssize_t bytes = fillIovec(requests, i, j, iov);
+            ssize_t res = pwritev(requests[i].fd, iov, j - i, requests[i].offset);
+            assert(res == bytes);
+        }
+    }
+};
+
+/* 基于 io_uring 的批量读写，直接使用系统调用而不依赖 liburing。
+ * 一批请求一次提交、一次等待，多段向量读写在内核中重叠进行。
+ * 写回线程与查询线程可能同时提交，故以互斥锁保护提交队列。
+ */
+class UringPageIO : public PageIO {
+private:
+    int ringFd;
+    unsigned entries;
+    char *sqRing, *cqRing;
+    size_t sqRingSize, cqRingSize;
+    io_uring_sqe *sqes;
+    unsigned *sqHead, *sqTail, *sqMask, *sqArray;
+    unsigned *cqHead, *cqTail, *cqMask;
+    io_uring_cqe *cqes;
+    std::mutex mutex;
+
+    static int setup(unsigned entries, io_uring_params *params) {
+        return (int) syscall(__NR_io_uring_setup, entries, params);
+    }
+
+    static int enter(int fd, unsigned submit, unsigned complete, unsigned flags) {
+        return (int) syscall(__NR_io_uring_enter, fd, submit, complete, flags, nullptr, 0);
+    }
+
+    // 提交 n 个不超过队列长度的向量读写并等待全部完成。写入不完整视为错误，读入不完整时其后的部分清零。
+    void submitBatch(PageRequest *requests, const int *starts, const ssize_t *bytes, int n, iovec *iov, int opcode) {
+        unsigned tail = *sqTail;
+        for (int i = 0; i < n; i++) {
+            unsigned idx = tail & *sqMask;
+            io_uring_sqe *sqe = &sqes[idx];
+            memset(sqe, 0, sizeof(io_uring_sqe));
+            sqe->opcode = opcode;
+            sqe->fd = requests[starts[i]].fd;
+            sqe->addr = (unsigned long long) (iov + starts[i]);
+            sqe->len = starts[i+1] - starts[i];
+            sqe->off = requests[starts[i]].offset;
+            sqe->user_data = i;
+            sqArray[idx] = idx;
+            tail++;
+        }
+        __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+        int submitted = 0, completed = 0;
+        while (completed < n) {
+            int ret = enter(ringFd, n - submitted, 1, IORING_ENTER_GETEVENTS);
+            assert(ret >= 0 || errno == EINTR);
+            if (ret > 0) submitted += ret;
+            unsigned head = *cqHead;
+            while (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+                io_uring_cqe *cqe = &cqes[head & *cqMask];
+                int i = cqe->user_data;
+                if (opcode == IORING_OP_WRITEV)
+                    assert(cqe->res == bytes[i]);
+                else {
+                    assert(cqe->res >= 0);
+                    if (cqe->res < bytes[i]) zeroTail(requests, starts[i], starts[i+1], cqe->res);
+                }
+                head++; completed++;
+            }
+            __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+        }
+    }
+
+    void submit(PageRequest *requests, int n, int opcode) {
+        std::vector<iovec> iov(n);
+        std::vector<int> starts;
+        std::vector<ssize_t> bytes;
+        for (int i = 0, j; i < n; i = j) {
+            j = runEnd(requests, n, i);
+            bytes.push_back(fillIovec(requests, i, j, iov.data() + i));
+            starts.push_back(i);
+        }
+        starts.push_back(n);
+        std::lock_guard<std::mutex> guard(mutex);
+        int runs = starts.size() - 1;
+        for (int i = 0; i < runs; i += entries)
+            submitBatch(requests, starts.data() + i, bytes.data() + i, std::min(runs - i, (int) entries), iov.data(), opcode);
+    }
+
+public:
+    UringPageIO() : ringFd(-1), sqRing(nullptr), cqRing(nullptr), sqes(nullptr) {}
+
+    ~UringPageIO() {
+        if (sqes != nullptr) munmap(sqes, entries * sizeof(io_uring_sqe));
+        if (cqRing != nullptr && cqRing != sqRing) munmap(cqRing, cqRingSize);
+        if (sqRing != nullptr) munmap(sqRing, sqRingSize);
+        if (ringFd >= 0) ::close(ringFd);
+    }
+
+    // 建立提交与完成队列，失败时返回 false。
+    bool init() {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        ringFd = setup(URING_ENTRIES, &params);
+        if (ringFd < 0) return false;
+        // 要求 IORING_FEAT_NODROP（Linux 5.5），完成队列不会丢失事件
+        if (!(params.features & IORING_FEAT_NODROP)) return false;
+        entries = params.sq_entries;
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        void *ptr = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+        if (ptr == MAP_FAILED) return false;
+        sqRing = (char*) ptr;
+        if (single) cqRing = sqRing;
+        else {
+            ptr = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+            if (ptr == MAP_FAILED) return false;
+            cqRing = (char*) ptr;
+        }
+        ptr = mmap(nullptr, entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+        if (ptr == MAP_FAILED) return false;
+        sqes = (io_uring_sqe*) ptr;
+        sqHead = (unsigned*) (sqRing + params.sq_off.head);
+        sqTail = (unsigned*) (sqRing + params.sq_off.tail);
+        sqMask = (unsigned*) (sqRing + params.sq_off.ring_mask);
+        sqArray = (unsigned*) (sqRing + params.sq_off.array);
+        cqHead = (unsigned*) (cqRing + params.cq_off.head);
+        cqTail = (unsigned*) (cqRing + params.cq_off.tail);
+        cqMask = (unsigned*) (cqRing + params.cq_off.ring_mask);
+        cqes = (io_uring_cqe*) (cqRing + params.cq_off.cqes);
+        return true;
+    }
+
+    void read(PageRequest *requests, int n) {
+        submit(requests, n, IORING_OP_READV);
+    }
+
+    void write(PageRequest *requests, int n) {
+        submit(requests, n, IORING_OP_WRITEV);
+    }
+};
+
+inline PageIO *PageIO::create(bool uring) {
+    if (uring) {
+        UringPageIO *ret = new UringPageIO();
+        if (ret->init()) return ret;
+        delete ret;
+    }
+    return new SyncPageIO();
+}
+
+#endif
@@ -2,11 +2,25 @@
 #define __CONSTANTS_H__
 
 //----------------------FILE---------------------------------------
-#define PAGE_SIZE 8192
+#define PAGE_SIZE 8192 // 默认页大小，数据库可在创建时另行指定
 #define PAGE_INT_NUM 2048
 #define PAGE_IDX 13
+#define MIN_PAGE_SIZE 4096
+#define MAX_PAGE_SIZE 65536
 #define MAX_FILE_NUM 128
-#define BUF_CAPACITY 60000
+#define BUF_CAPACITY 60000 // 默认缓存页数（按 PAGE_SIZE 计），可在启动时指定
+#define BUF_CHUNK_PAGES 1024 // 缓存按块分配，每块的页数
+#define BUF_WRITER_BATCH 32 // 后台线程每批写回的页数
+#define BUF_WRITER_FRACTION 4 // 未指定脏页上限时取缓存页数的这么多分之一
+#define BUF_MAX_SHARDS 16 // 自动选取时缓存分片数的上限
+#define BUF_SHARD_MIN_PAGES 1024 // 自动选取时每个分片的最少页数
+#define BUF_SHARD_SPAN 16 // 同一文件中这么多页的区段位于同一分片
+#define URING_ENTRIES 64 // io_uring 提交队列长度
+#define READAHEAD_PAGES 32 // 顺序预读的默认页数
+#define READAHEAD_TRIGGER 3 // 连续顺序访问这么多页后开始预读
+#define MMAP_RESERVE_PAGES (1 << 21) // 映射模式下每个文件预留的地址空间页数（16GB）
+#define MMAP_CHUNK_PAGES 1024 // 映射模式下每次映射的页数
+#define PAGE_COMPRESS_BLOCK 4096 // 压缩页面按这么多字节的块写入，与文件系统的块大小一致
 #define PAGE_FOOTER_SIZE 64
 #define MAX_REC_PER_PAGE 512
 
@@ -0,0 +1,22 @@
+#!/bin/bash
+# 回归测试：regress/ 下的每个 .sql 在新建的空目录中按下列缓存配置各运行一次，
+# 输出须与同名的 .expected 完全一致。
+# 用法：./regress.sh [ktdb.out 路径]，默认为 ../build/ktdb.out
+cd "$(dirname "$0")"
+BIN=$(realpath "${1:-../build/ktdb.out}")
+MODES=("" "-B 16" "-B 16 -R 2q" "-M")
+failed=0
+for sql in regress/*.sql; do
+    for mode in "${MODES[@]}"; do
+        dir=$(mktemp -d)
+        (cd "$dir" && timeout 60 "$BIN" -F $mode < "$OLDPWD/$sql" > out.txt 2>&1)
+        if cmp -s "$dir/out.txt" "${sql%.sql}.expected"; then
+            echo "PASS $sql $mode"
+        else
+            echo "FAIL $sql $mode"
+            failed=1
+        fi
+        rm -rf "$dir"
+    done
+done
+exit $failed
@@ -0,0 +1,14 @@
+/* 比内部节点第一个分隔键更小的键：插入时进入第一个子节点而分隔键不变，查询须同样进入第一个子节点 */
+CREATE DATABASE regress;
+USE regress;
+CREATE TABLE t (k VARCHAR(200), v INT(10), PRIMARY KEY (k));
+INSERT INTO t VALUES ('k100', 100), ('k101', 101), ('k102', 102), ('k103', 103), ('k104', 104), ('k105', 105), ('k106', 106), ('k107', 107), ('k108', 108), ('k109', 109), ('k110', 110), ('k111', 111), ('k112', 112), ('k113', 113), ('k114', 114), ('k115', 115), ('k116', 116), ('k117', 117), ('k118', 118), ('k119', 119), ('k120', 120), ('k121', 121), ('k122', 122), ('k123', 123), ('k124', 124), ('k125', 125), ('k126', 126), ('k127', 127), ('k128', 128), ('k129', 129), ('k130', 130), ('k131', 131), ('k132', 132), ('k133', 133), ('k134', 134), ('k135', 135), ('k136', 136), ('k137', 137), ('k138', 138), ('k139', 139), ('k140', 140), ('k141', 141), ('k142', 142), ('k143', 143), ('k144', 144), ('k145', 145), ('k146', 146), ('k147', 147), ('k148', 148), ('k149', 149), ('k150', 150), ('k151', 151), ('k152', 152), ('k153', 153), ('k154', 154), ('k155', 155), ('k156', 156), ('k157', 157), ('k158', 158), ('k159', 159), ('k160', 160), ('k161', 161), ('k162', 162), ('k163', 163), ('k164', 164), ('k165', 165), ('k166', 166), ('k167', 167), ('k168', 168), ('k169', 169), ('k170', 170), ('k171', 171), ('k172', 172), ('k173', 173), ('k174', 174), ('k175', 175), ('k176', 176), ('k177', 177), ('k178', 178), ('k179', 179), ('k180', 180), ('k181', 181), ('k182', 182), ('k183', 183), ('k184', 184), ('k185', 185), ('k186', 186), ('k187', 187), ('k188', 188), ('k189', 189), ('k190', 190), ('k191', 191), ('k192', 192), ('k193', 193), ('k194', 194), ('k195', 195), ('k196', 196), ('k197', 197), ('k198', 198), ('k199', 199);
+INSERT INTO t VALUES ('a', 1);
+SELECT * FROM t WHERE k = 'a';
+INSERT INTO t VALUES ('a', 2);
+SELECT * FROM t WHERE k < 'k101';
+DELETE FROM t WHERE k = 'a';
+SELECT * FROM t WHERE k = 'a';
+INSERT INTO t VALUES ('a', 3);
+SELECT * FROM t WHERE k <= 'k100';
+DROP DATABASE regress;
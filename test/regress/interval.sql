@@ -0,0 +1,21 @@
+/* 区间内没有键的索引查询：a = 25、20 < a < 30 等曾使 queryInterval 越过最后一个叶节点而无法结束 */
+CREATE DATABASE regress;
+USE regress;
+CREATE TABLE t (a INT(10), b VARCHAR(20), c INT(10), PRIMARY KEY (a));
+CREATE INDEX ci ON t (c);
+INSERT INTO t VALUES (10, 'x10', 1), (20, 'x20', 2), (30, 'x30', 3), (40, 'x40', 4), (50, 'x50', 5);
+SELECT * FROM t WHERE a = 20;
+SELECT * FROM t WHERE a = 25;
+SELECT * FROM t WHERE a > 20 AND a < 30;
+SELECT * FROM t WHERE a >= 21 AND a <= 29;
+SELECT * FROM t WHERE a = 5;
+SELECT * FROM t WHERE a = 55;
+SELECT * FROM t WHERE c = 3;
+SELECT * FROM t WHERE c = 6;
+DELETE FROM t WHERE a = 30;
+SELECT * FROM t WHERE a = 30;
+VACUUM t;
+SELECT * FROM t WHERE a = 30;
+SELECT * FROM t WHERE c > 2 AND c < 4;
+SELECT * FROM t;
+DROP DATABASE regress;
@@ -0,0 +1,32 @@
+/* 压缩页下的插入、删除、更新、清理与索引查询；行数足以跨越多页，-B 16 时会反复换出 */
+CREATE DATABASE regress;
+USE regress;
+CREATE TABLE t (id INT(10), name VARCHAR(60), score FLOAT, c INT(10), PRIMARY KEY (id)) COMPRESSED;
+INSERT INTO t VALUES (0, 'n0', 0.5, 0), (1, 'n1x', 1.5, 1), (2, 'n2xx', 2.5, 2), (3, 'n3xxx', 3.5, 3), (4, 'n4xxxx', 4.5, 4), (5, 'n5xxxxx', 5.5, 5), (6, 'n6xxxxxx', 6.5, 6), (7, 'n7xxxxxxx', 7.5, 0), (8, 'n8xxxxxxxx', 8.5, 1), (9, 'n9xxxxxxxxx', 9.5, 2), (10, 'n10xxxxxxxxxx', 10.5, 3), (11, 'n11xxxxxxxxxxx', 11.5, 4), (12, 'n12xxxxxxxxxxxx', 12.5, 5), (13, 'n13xxxxxxxxxxxxx', 13.5, 6), (14, 'n14xxxxxxxxxxxxxx', 14.5, 0), (15, 'n15xxxxxxxxxxxxxxx', 15.5, 1), (16, 'n16xxxxxxxxxxxxxxxx', 16.5, 2), (17, 'n17xxxxxxxxxxxxxxxxx', 17.5, 3), (18, 'n18xxxxxxxxxxxxxxxxxx', 18.5, 4), (19, 'n19xxxxxxxxxxxxxxxxxxx', 19.5, 5), (20, 'n20xxxxxxxxxxxxxxxxxxxx', 20.5, 6), (21, 'n21xxxxxxxxxxxxxxxxxxxxx', 21.5, 0), (22, 'n22xxxxxxxxxxxxxxxxxxxxxx', 22.5, 1), (23, 'n23xxxxxxxxxxxxxxxxxxxxxxx', 23.5, 2), (24, 'n24xxxxxxxxxxxxxxxxxxxxxxxx', 24.5, 3), (25, 'n25xxxxxxxxxxxxxxxxxxxxxxxxx', 25.5, 4), (26, 'n26xxxxxxxxxxxxxxxxxxxxxxxxxx', 26.5, 5), (27, 'n27xxxxxxxxxxxxxxxxxxxxxxxxxxx', 27.5, 6), (28, 'n28xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 28.5, 0), (29, 'n29xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 29.5, 1), (30, 'n30xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 30.5, 2), (31, 'n31xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 31.5, 3), (32, 'n32xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 32.5, 4), (33, 'n33xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 33.5, 5), (34, 'n34xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 34.5, 6), (35, 'n35xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 35.5, 0), (36, 'n36xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 36.5, 1), (37, 'n37xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 37.5, 2), (38, 'n38xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 38.5, 3), (39, 'n39xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 39.5, 4), (40, 'n40', 40.5, 5), (41, 'n41x', 41.5, 6), (42, 'n42xx', 42.5, 0), (43, 'n43xxx', 43.5, 1), (44, 'n44xxxx', 44.5, 2), (45, 'n45xxxxx', 45.5, 3), (46, 'n46xxxxxx', 46.5, 4), (47, 'n47xxxxxxx', 47.5, 5), (48, 'n48xxxxxxxx', 48.5, 6), (49, 'n49xxxxxxxxx', 49.5, 0), (50, 'n50xxxxxxxxxx', 50.5, 1), (51, 'n51xxxxxxxxxxx', 51.5, 2), (52, 'n52xxxxxxxxxxxx', 52.5, 3), (53, 'n53xxxxxxxxxxxxx', 53.5, 4), (54, 'n54xxxxxxxxxxxxxx', 54.5, 5), (55, 'n55xxxxxxxxxxxxxxx', 55.5, 6), (56, 'n56xxxxxxxxxxxxxxxx', 56.5, 0), (57, 'n57xxxxxxxxxxxxxxxxx', 57.5, 1), (58, 'n58xxxxxxxxxxxxxxxxxx', 58.5, 2), (59, 'n59xxxxxxxxxxxxxxxxxxx', 59.5, 3), (60, 'n60xxxxxxxxxxxxxxxxxxxx', 60.5, 4), (61, 'n61xxxxxxxxxxxxxxxxxxxxx', 61.5, 5), (62, 'n62xxxxxxxxxxxxxxxxxxxxxx', 62.5, 6), (63, 'n63xxxxxxxxxxxxxxxxxxxxxxx', 63.5, 0), (64, 'n64xxxxxxxxxxxxxxxxxxxxxxxx', 64.5, 1), (65, 'n65xxxxxxxxxxxxxxxxxxxxxxxxx', 65.5, 2), (66, 'n66xxxxxxxxxxxxxxxxxxxxxxxxxx', 66.5, 3), (67, 'n67xxxxxxxxxxxxxxxxxxxxxxxxxxx', 67.5, 4), (68, 'n68xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 68.5, 5), (69, 'n69xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 69.5, 6), (70, 'n70xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 70.5, 0), (71, 'n71xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 71.5, 1), (72, 'n72xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 72.5, 2), (73, 'n73xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 73.5, 3), (74, 'n74xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 74.5, 4), (75, 'n75xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 75.5, 5), (76, 'n76xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 76.5, 6), (77, 'n77xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 77.5, 0), (78, 'n78xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 78.5, 1), (79, 'n79xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 79.5, 2), (80, 'n80', 80.5, 3), (81, 'n81x', 81.5, 4), (82, 'n82xx', 82.5, 5), (83, 'n83xxx', 83.5, 6), (84, 'n84xxxx', 84.5, 0), (85, 'n85xxxxx', 85.5, 1), (86, 'n86xxxxxx', 86.5, 2), (87, 'n87xxxxxxx', 87.5, 3), (88, 'n88xxxxxxxx', 88.5, 4), (89, 'n89xxxxxxxxx', 89.5, 5), (90, 'n90xxxxxxxxxx', 90.5, 6), (91, 'n91xxxxxxxxxxx', 91.5, 0), (92, 'n92xxxxxxxxxxxx', 92.5, 1), (93, 'n93xxxxxxxxxxxxx', 93.5, 2), (94, 'n94xxxxxxxxxxxxxx', 94.5, 3), (95, 'n95xxxxxxxxxxxxxxx', 95.5, 4), (96, 'n96xxxxxxxxxxxxxxxx', 96.5, 5), (97, 'n97xxxxxxxxxxxxxxxxx', 97.5, 6), (98, 'n98xxxxxxxxxxxxxxxxxx', 98.5, 0), (99, 'n99xxxxxxxxxxxxxxxxxxx', 99.5, 1);
+INSERT INTO t VALUES (100, 'n100xxxxxxxxxxxxxxxxxxxx', 0.5, 2), (101, 'n101xxxxxxxxxxxxxxxxxxxxx', 1.5, 3), (102, 'n102xxxxxxxxxxxxxxxxxxxxxx', 2.5, 4), (103, 'n103xxxxxxxxxxxxxxxxxxxxxxx', 3.5, 5), (104, 'n104xxxxxxxxxxxxxxxxxxxxxxxx', 4.5, 6), (105, 'n105xxxxxxxxxxxxxxxxxxxxxxxxx', 5.5, 0), (106, 'n106xxxxxxxxxxxxxxxxxxxxxxxxxx', 6.5, 1), (107, 'n107xxxxxxxxxxxxxxxxxxxxxxxxxxx', 7.5, 2), (108, 'n108xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 8.5, 3), (109, 'n109xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 9.5, 4), (110, 'n110xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 10.5, 5), (111, 'n111xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 11.5, 6), (112, 'n112xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 12.5, 0), (113, 'n113xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 13.5, 1), (114, 'n114xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 14.5, 2), (115, 'n115xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 15.5, 3), (116, 'n116xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 16.5, 4), (117, 'n117xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 17.5, 5), (118, 'n118xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 18.5, 6), (119, 'n119xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 19.5, 0), (120, 'n120', 20.5, 1), (121, 'n121x', 21.5, 2), (122, 'n122xx', 22.5, 3), (123, 'n123xxx', 23.5, 4), (124, 'n124xxxx', 24.5, 5), (125, 'n125xxxxx', 25.5, 6), (126, 'n126xxxxxx', 26.5, 0), (127, 'n127xxxxxxx', 27.5, 1), (128, 'n128xxxxxxxx', 28.5, 2), (129, 'n129xxxxxxxxx', 29.5, 3), (130, 'n130xxxxxxxxxx', 30.5, 4), (131, 'n131xxxxxxxxxxx', 31.5, 5), (132, 'n132xxxxxxxxxxxx', 32.5, 6), (133, 'n133xxxxxxxxxxxxx', 33.5, 0), (134, 'n134xxxxxxxxxxxxxx', 34.5, 1), (135, 'n135xxxxxxxxxxxxxxx', 35.5, 2), (136, 'n136xxxxxxxxxxxxxxxx', 36.5, 3), (137, 'n137xxxxxxxxxxxxxxxxx', 37.5, 4), (138, 'n138xxxxxxxxxxxxxxxxxx', 38.5, 5), (139, 'n139xxxxxxxxxxxxxxxxxxx', 39.5, 6), (140, 'n140xxxxxxxxxxxxxxxxxxxx', 40.5, 0), (141, 'n141xxxxxxxxxxxxxxxxxxxxx', 41.5, 1), (142, 'n142xxxxxxxxxxxxxxxxxxxxxx', 42.5, 2), (143, 'n143xxxxxxxxxxxxxxxxxxxxxxx', 43.5, 3), (144, 'n144xxxxxxxxxxxxxxxxxxxxxxxx', 44.5, 4), (145, 'n145xxxxxxxxxxxxxxxxxxxxxxxxx', 45.5, 5), (146, 'n146xxxxxxxxxxxxxxxxxxxxxxxxxx', 46.5, 6), (147, 'n147xxxxxxxxxxxxxxxxxxxxxxxxxxx', 47.5, 0), (148, 'n148xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 48.5, 1), (149, 'n149xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 49.5, 2), (150, 'n150xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 50.5, 3), (151, 'n151xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 51.5, 4), (152, 'n152xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 52.5, 5), (153, 'n153xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 53.5, 6), (154, 'n154xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 54.5, 0), (155, 'n155xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 55.5, 1), (156, 'n156xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 56.5, 2), (157, 'n157xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 57.5, 3), (158, 'n158xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 58.5, 4), (159, 'n159xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 59.5, 5), (160, 'n160', 60.5, 6), (161, 'n161x', 61.5, 0), (162, 'n162xx', 62.5, 1), (163, 'n163xxx', 63.5, 2), (164, 'n164xxxx', 64.5, 3), (165, 'n165xxxxx', 65.5, 4), (166, 'n166xxxxxx', 66.5, 5), (167, 'n167xxxxxxx', 67.5, 6), (168, 'n168xxxxxxxx', 68.5, 0), (169, 'n169xxxxxxxxx', 69.5, 1), (170, 'n170xxxxxxxxxx', 70.5, 2), (171, 'n171xxxxxxxxxxx', 71.5, 3), (172, 'n172xxxxxxxxxxxx', 72.5, 4), (173, 'n173xxxxxxxxxxxxx', 73.5, 5), (174, 'n174xxxxxxxxxxxxxx', 74.5, 6), (175, 'n175xxxxxxxxxxxxxxx', 75.5, 0), (176, 'n176xxxxxxxxxxxxxxxx', 76.5, 1), (177, 'n177xxxxxxxxxxxxxxxxx', 77.5, 2), (178, 'n178xxxxxxxxxxxxxxxxxx', 78.5, 3), (179, 'n179xxxxxxxxxxxxxxxxxxx', 79.5, 4), (180, 'n180xxxxxxxxxxxxxxxxxxxx', 80.5, 5), (181, 'n181xxxxxxxxxxxxxxxxxxxxx', 81.5, 6), (182, 'n182xxxxxxxxxxxxxxxxxxxxxx', 82.5, 0), (183, 'n183xxxxxxxxxxxxxxxxxxxxxxx', 83.5, 1), (184, 'n184xxxxxxxxxxxxxxxxxxxxxxxx', 84.5, 2), (185, 'n185xxxxxxxxxxxxxxxxxxxxxxxxx', 85.5, 3), (186, 'n186xxxxxxxxxxxxxxxxxxxxxxxxxx', 86.5, 4), (187, 'n187xxxxxxxxxxxxxxxxxxxxxxxxxxx', 87.5, 5), (188, 'n188xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 88.5, 6), (189, 'n189xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 89.5, 0), (190, 'n190xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 90.5, 1), (191, 'n191xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 91.5, 2), (192, 'n192xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 92.5, 3), (193, 'n193xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 93.5, 4), (194, 'n194xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 94.5, 5), (195, 'n195xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 95.5, 6), (196, 'n196xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 96.5, 0), (197, 'n197xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 97.5, 1), (198, 'n198xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 98.5, 2), (199, 'n199xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 99.5, 3);
+INSERT INTO t VALUES (200, 'n200', 0.5, 4), (201, 'n201x', 1.5, 5), (202, 'n202xx', 2.5, 6), (203, 'n203xxx', 3.5, 0), (204, 'n204xxxx', 4.5, 1), (205, 'n205xxxxx', 5.5, 2), (206, 'n206xxxxxx', 6.5, 3), (207, 'n207xxxxxxx', 7.5, 4), (208, 'n208xxxxxxxx', 8.5, 5), (209, 'n209xxxxxxxxx', 9.5, 6), (210, 'n210xxxxxxxxxx', 10.5, 0), (211, 'n211xxxxxxxxxxx', 11.5, 1), (212, 'n212xxxxxxxxxxxx', 12.5, 2), (213, 'n213xxxxxxxxxxxxx', 13.5, 3), (214, 'n214xxxxxxxxxxxxxx', 14.5, 4), (215, 'n215xxxxxxxxxxxxxxx', 15.5, 5), (216, 'n216xxxxxxxxxxxxxxxx', 16.5, 6), (217, 'n217xxxxxxxxxxxxxxxxx', 17.5, 0), (218, 'n218xxxxxxxxxxxxxxxxxx', 18.5, 1), (219, 'n219xxxxxxxxxxxxxxxxxxx', 19.5, 2), (220, 'n220xxxxxxxxxxxxxxxxxxxx', 20.5, 3), (221, 'n221xxxxxxxxxxxxxxxxxxxxx', 21.5, 4), (222, 'n222xxxxxxxxxxxxxxxxxxxxxx', 22.5, 5), (223, 'n223xxxxxxxxxxxxxxxxxxxxxxx', 23.5, 6), (224, 'n224xxxxxxxxxxxxxxxxxxxxxxxx', 24.5, 0), (225, 'n225xxxxxxxxxxxxxxxxxxxxxxxxx', 25.5, 1), (226, 'n226xxxxxxxxxxxxxxxxxxxxxxxxxx', 26.5, 2), (227, 'n227xxxxxxxxxxxxxxxxxxxxxxxxxxx', 27.5, 3), (228, 'n228xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 28.5, 4), (229, 'n229xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 29.5, 5), (230, 'n230xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 30.5, 6), (231, 'n231xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 31.5, 0), (232, 'n232xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 32.5, 1), (233, 'n233xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 33.5, 2), (234, 'n234xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 34.5, 3), (235, 'n235xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 35.5, 4), (236, 'n236xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 36.5, 5), (237, 'n237xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 37.5, 6), (238, 'n238xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 38.5, 0), (239, 'n239xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 39.5, 1), (240, 'n240', 40.5, 2), (241, 'n241x', 41.5, 3), (242, 'n242xx', 42.5, 4), (243, 'n243xxx', 43.5, 5), (244, 'n244xxxx', 44.5, 6), (245, 'n245xxxxx', 45.5, 0), (246, 'n246xxxxxx', 46.5, 1), (247, 'n247xxxxxxx', 47.5, 2), (248, 'n248xxxxxxxx', 48.5, 3), (249, 'n249xxxxxxxxx', 49.5, 4), (250, 'n250xxxxxxxxxx', 50.5, 5), (251, 'n251xxxxxxxxxxx', 51.5, 6), (252, 'n252xxxxxxxxxxxx', 52.5, 0), (253, 'n253xxxxxxxxxxxxx', 53.5, 1), (254, 'n254xxxxxxxxxxxxxx', 54.5, 2), (255, 'n255xxxxxxxxxxxxxxx', 55.5, 3), (256, 'n256xxxxxxxxxxxxxxxx', 56.5, 4), (257, 'n257xxxxxxxxxxxxxxxxx', 57.5, 5), (258, 'n258xxxxxxxxxxxxxxxxxx', 58.5, 6), (259, 'n259xxxxxxxxxxxxxxxxxxx', 59.5, 0), (260, 'n260xxxxxxxxxxxxxxxxxxxx', 60.5, 1), (261, 'n261xxxxxxxxxxxxxxxxxxxxx', 61.5, 2), (262, 'n262xxxxxxxxxxxxxxxxxxxxxx', 62.5, 3), (263, 'n263xxxxxxxxxxxxxxxxxxxxxxx', 63.5, 4), (264, 'n264xxxxxxxxxxxxxxxxxxxxxxxx', 64.5, 5), (265, 'n265xxxxxxxxxxxxxxxxxxxxxxxxx', 65.5, 6), (266, 'n266xxxxxxxxxxxxxxxxxxxxxxxxxx', 66.5, 0), (267, 'n267xxxxxxxxxxxxxxxxxxxxxxxxxxx', 67.5, 1), (268, 'n268xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 68.5, 2), (269, 'n269xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 69.5, 3), (270, 'n270xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 70.5, 4), (271, 'n271xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 71.5, 5), (272, 'n272xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 72.5, 6), (273, 'n273xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 73.5, 0), (274, 'n274xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 74.5, 1), (275, 'n275xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 75.5, 2), (276, 'n276xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 76.5, 3), (277, 'n277xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 77.5, 4), (278, 'n278xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 78.5, 5), (279, 'n279xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 79.5, 6), (280, 'n280', 80.5, 0), (281, 'n281x', 81.5, 1), (282, 'n282xx', 82.5, 2), (283, 'n283xxx', 83.5, 3), (284, 'n284xxxx', 84.5, 4), (285, 'n285xxxxx', 85.5, 5), (286, 'n286xxxxxx', 86.5, 6), (287, 'n287xxxxxxx', 87.5, 0), (288, 'n288xxxxxxxx', 88.5, 1), (289, 'n289xxxxxxxxx', 89.5, 2), (290, 'n290xxxxxxxxxx', 90.5, 3), (291, 'n291xxxxxxxxxxx', 91.5, 4), (292, 'n292xxxxxxxxxxxx', 92.5, 5), (293, 'n293xxxxxxxxxxxxx', 93.5, 6), (294, 'n294xxxxxxxxxxxxxx', 94.5, 0), (295, 'n295xxxxxxxxxxxxxxx', 95.5, 1), (296, 'n296xxxxxxxxxxxxxxxx', 96.5, 2), (297, 'n297xxxxxxxxxxxxxxxxx', 97.5, 3), (298, 'n298xxxxxxxxxxxxxxxxxx', 98.5, 4), (299, 'n299xxxxxxxxxxxxxxxxxxx', 99.5, 5);
+INSERT INTO t VALUES (300, 'n300xxxxxxxxxxxxxxxxxxxx', 0.5, 6), (301, 'n301xxxxxxxxxxxxxxxxxxxxx', 1.5, 0), (302, 'n302xxxxxxxxxxxxxxxxxxxxxx', 2.5, 1), (303, 'n303xxxxxxxxxxxxxxxxxxxxxxx', 3.5, 2), (304, 'n304xxxxxxxxxxxxxxxxxxxxxxxx', 4.5, 3), (305, 'n305xxxxxxxxxxxxxxxxxxxxxxxxx', 5.5, 4), (306, 'n306xxxxxxxxxxxxxxxxxxxxxxxxxx', 6.5, 5), (307, 'n307xxxxxxxxxxxxxxxxxxxxxxxxxxx', 7.5, 6), (308, 'n308xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 8.5, 0), (309, 'n309xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 9.5, 1), (310, 'n310xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 10.5, 2), (311, 'n311xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 11.5, 3), (312, 'n312xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 12.5, 4), (313, 'n313xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 13.5, 5), (314, 'n314xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 14.5, 6), (315, 'n315xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 15.5, 0), (316, 'n316xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 16.5, 1), (317, 'n317xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 17.5, 2), (318, 'n318xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 18.5, 3), (319, 'n319xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 19.5, 4), (320, 'n320', 20.5, 5), (321, 'n321x', 21.5, 6), (322, 'n322xx', 22.5, 0), (323, 'n323xxx', 23.5, 1), (324, 'n324xxxx', 24.5, 2), (325, 'n325xxxxx', 25.5, 3), (326, 'n326xxxxxx', 26.5, 4), (327, 'n327xxxxxxx', 27.5, 5), (328, 'n328xxxxxxxx', 28.5, 6), (329, 'n329xxxxxxxxx', 29.5, 0), (330, 'n330xxxxxxxxxx', 30.5, 1), (331, 'n331xxxxxxxxxxx', 31.5, 2), (332, 'n332xxxxxxxxxxxx', 32.5, 3), (333, 'n333xxxxxxxxxxxxx', 33.5, 4), (334, 'n334xxxxxxxxxxxxxx', 34.5, 5), (335, 'n335xxxxxxxxxxxxxxx', 35.5, 6), (336, 'n336xxxxxxxxxxxxxxxx', 36.5, 0), (337, 'n337xxxxxxxxxxxxxxxxx', 37.5, 1), (338, 'n338xxxxxxxxxxxxxxxxxx', 38.5, 2), (339, 'n339xxxxxxxxxxxxxxxxxxx', 39.5, 3), (340, 'n340xxxxxxxxxxxxxxxxxxxx', 40.5, 4), (341, 'n341xxxxxxxxxxxxxxxxxxxxx', 41.5, 5), (342, 'n342xxxxxxxxxxxxxxxxxxxxxx', 42.5, 6), (343, 'n343xxxxxxxxxxxxxxxxxxxxxxx', 43.5, 0), (344, 'n344xxxxxxxxxxxxxxxxxxxxxxxx', 44.5, 1), (345, 'n345xxxxxxxxxxxxxxxxxxxxxxxxx', 45.5, 2), (346, 'n346xxxxxxxxxxxxxxxxxxxxxxxxxx', 46.5, 3), (347, 'n347xxxxxxxxxxxxxxxxxxxxxxxxxxx', 47.5, 4), (348, 'n348xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 48.5, 5), (349, 'n349xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 49.5, 6), (350, 'n350xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 50.5, 0), (351, 'n351xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 51.5, 1), (352, 'n352xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 52.5, 2), (353, 'n353xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 53.5, 3), (354, 'n354xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 54.5, 4), (355, 'n355xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 55.5, 5), (356, 'n356xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 56.5, 6), (357, 'n357xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 57.5, 0), (358, 'n358xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 58.5, 1), (359, 'n359xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 59.5, 2), (360, 'n360', 60.5, 3), (361, 'n361x', 61.5, 4), (362, 'n362xx', 62.5, 5), (363, 'n363xxx', 63.5, 6), (364, 'n364xxxx', 64.5, 0), (365, 'n365xxxxx', 65.5, 1), (366, 'n366xxxxxx', 66.5, 2), (367, 'n367xxxxxxx', 67.5, 3), (368, 'n368xxxxxxxx', 68.5, 4), (369, 'n369xxxxxxxxx', 69.5, 5), (370, 'n370xxxxxxxxxx', 70.5, 6), (371, 'n371xxxxxxxxxxx', 71.5, 0), (372, 'n372xxxxxxxxxxxx', 72.5, 1), (373, 'n373xxxxxxxxxxxxx', 73.5, 2), (374, 'n374xxxxxxxxxxxxxx', 74.5, 3), (375, 'n375xxxxxxxxxxxxxxx', 75.5, 4), (376, 'n376xxxxxxxxxxxxxxxx', 76.5, 5), (377, 'n377xxxxxxxxxxxxxxxxx', 77.5, 6), (378, 'n378xxxxxxxxxxxxxxxxxx', 78.5, 0), (379, 'n379xxxxxxxxxxxxxxxxxxx', 79.5, 1), (380, 'n380xxxxxxxxxxxxxxxxxxxx', 80.5, 2), (381, 'n381xxxxxxxxxxxxxxxxxxxxx', 81.5, 3), (382, 'n382xxxxxxxxxxxxxxxxxxxxxx', 82.5, 4), (383, 'n383xxxxxxxxxxxxxxxxxxxxxxx', 83.5, 5), (384, 'n384xxxxxxxxxxxxxxxxxxxxxxxx', 84.5, 6), (385, 'n385xxxxxxxxxxxxxxxxxxxxxxxxx', 85.5, 0), (386, 'n386xxxxxxxxxxxxxxxxxxxxxxxxxx', 86.5, 1), (387, 'n387xxxxxxxxxxxxxxxxxxxxxxxxxxx', 87.5, 2), (388, 'n388xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 88.5, 3), (389, 'n389xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 89.5, 4), (390, 'n390xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 90.5, 5), (391, 'n391xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 91.5, 6), (392, 'n392xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 92.5, 0), (393, 'n393xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 93.5, 1), (394, 'n394xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 94.5, 2), (395, 'n395xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 95.5, 3), (396, 'n396xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 96.5, 4), (397, 'n397xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 97.5, 5), (398, 'n398xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 98.5, 6), (399, 'n399xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 99.5, 0);
+INSERT INTO t VALUES (400, 'n400', 0.5, 1), (401, 'n401x', 1.5, 2), (402, 'n402xx', 2.5, 3), (403, 'n403xxx', 3.5, 4), (404, 'n404xxxx', 4.5, 5), (405, 'n405xxxxx', 5.5, 6), (406, 'n406xxxxxx', 6.5, 0), (407, 'n407xxxxxxx', 7.5, 1), (408, 'n408xxxxxxxx', 8.5, 2), (409, 'n409xxxxxxxxx', 9.5, 3), (410, 'n410xxxxxxxxxx', 10.5, 4), (411, 'n411xxxxxxxxxxx', 11.5, 5), (412, 'n412xxxxxxxxxxxx', 12.5, 6), (413, 'n413xxxxxxxxxxxxx', 13.5, 0), (414, 'n414xxxxxxxxxxxxxx', 14.5, 1), (415, 'n415xxxxxxxxxxxxxxx', 15.5, 2), (416, 'n416xxxxxxxxxxxxxxxx', 16.5, 3), (417, 'n417xxxxxxxxxxxxxxxxx', 17.5, 4), (418, 'n418xxxxxxxxxxxxxxxxxx', 18.5, 5), (419, 'n419xxxxxxxxxxxxxxxxxxx', 19.5, 6), (420, 'n420xxxxxxxxxxxxxxxxxxxx', 20.5, 0), (421, 'n421xxxxxxxxxxxxxxxxxxxxx', 21.5, 1), (422, 'n422xxxxxxxxxxxxxxxxxxxxxx', 22.5, 2), (423, 'n423xxxxxxxxxxxxxxxxxxxxxxx', 23.5, 3), (424, 'n424xxxxxxxxxxxxxxxxxxxxxxxx', 24.5, 4), (425, 'n425xxxxxxxxxxxxxxxxxxxxxxxxx', 25.5, 5), (426, 'n426xxxxxxxxxxxxxxxxxxxxxxxxxx', 26.5, 6), (427, 'n427xxxxxxxxxxxxxxxxxxxxxxxxxxx', 27.5, 0), (428, 'n428xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 28.5, 1), (429, 'n429xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 29.5, 2), (430, 'n430xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 30.5, 3), (431, 'n431xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 31.5, 4), (432, 'n432xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 32.5, 5), (433, 'n433xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 33.5, 6), (434, 'n434xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 34.5, 0), (435, 'n435xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 35.5, 1), (436, 'n436xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 36.5, 2), (437, 'n437xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 37.5, 3), (438, 'n438xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 38.5, 4), (439, 'n439xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 39.5, 5), (440, 'n440', 40.5, 6), (441, 'n441x', 41.5, 0), (442, 'n442xx', 42.5, 1), (443, 'n443xxx', 43.5, 2), (444, 'n444xxxx', 44.5, 3), (445, 'n445xxxxx', 45.5, 4), (446, 'n446xxxxxx', 46.5, 5), (447, 'n447xxxxxxx', 47.5, 6), (448, 'n448xxxxxxxx', 48.5, 0), (449, 'n449xxxxxxxxx', 49.5, 1), (450, 'n450xxxxxxxxxx', 50.5, 2), (451, 'n451xxxxxxxxxxx', 51.5, 3), (452, 'n452xxxxxxxxxxxx', 52.5, 4), (453, 'n453xxxxxxxxxxxxx', 53.5, 5), (454, 'n454xxxxxxxxxxxxxx', 54.5, 6), (455, 'n455xxxxxxxxxxxxxxx', 55.5, 0), (456, 'n456xxxxxxxxxxxxxxxx', 56.5, 1), (457, 'n457xxxxxxxxxxxxxxxxx', 57.5, 2), (458, 'n458xxxxxxxxxxxxxxxxxx', 58.5, 3), (459, 'n459xxxxxxxxxxxxxxxxxxx', 59.5, 4), (460, 'n460xxxxxxxxxxxxxxxxxxxx', 60.5, 5), (461, 'n461xxxxxxxxxxxxxxxxxxxxx', 61.5, 6), (462, 'n462xxxxxxxxxxxxxxxxxxxxxx', 62.5, 0), (463, 'n463xxxxxxxxxxxxxxxxxxxxxxx', 63.5, 1), (464, 'n464xxxxxxxxxxxxxxxxxxxxxxxx', 64.5, 2), (465, 'n465xxxxxxxxxxxxxxxxxxxxxxxxx', 65.5, 3), (466, 'n466xxxxxxxxxxxxxxxxxxxxxxxxxx', 66.5, 4), (467, 'n467xxxxxxxxxxxxxxxxxxxxxxxxxxx', 67.5, 5), (468, 'n468xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 68.5, 6), (469, 'n469xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 69.5, 0), (470, 'n470xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 70.5, 1), (471, 'n471xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 71.5, 2), (472, 'n472xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 72.5, 3), (473, 'n473xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 73.5, 4), (474, 'n474xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 74.5, 5), (475, 'n475xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 75.5, 6), (476, 'n476xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 76.5, 0), (477, 'n477xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 77.5, 1), (478, 'n478xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 78.5, 2), (479, 'n479xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 79.5, 3), (480, 'n480', 80.5, 4), (481, 'n481x', 81.5, 5), (482, 'n482xx', 82.5, 6), (483, 'n483xxx', 83.5, 0), (484, 'n484xxxx', 84.5, 1), (485, 'n485xxxxx', 85.5, 2), (486, 'n486xxxxxx', 86.5, 3), (487, 'n487xxxxxxx', 87.5, 4), (488, 'n488xxxxxxxx', 88.5, 5), (489, 'n489xxxxxxxxx', 89.5, 6), (490, 'n490xxxxxxxxxx', 90.5, 0), (491, 'n491xxxxxxxxxxx', 91.5, 1), (492, 'n492xxxxxxxxxxxx', 92.5, 2), (493, 'n493xxxxxxxxxxxxx', 93.5, 3), (494, 'n494xxxxxxxxxxxxxx', 94.5, 4), (495, 'n495xxxxxxxxxxxxxxx', 95.5, 5), (496, 'n496xxxxxxxxxxxxxxxx', 96.5, 6), (497, 'n497xxxxxxxxxxxxxxxxx', 97.5, 0), (498, 'n498xxxxxxxxxxxxxxxxxx', 98.5, 1), (499, 'n499xxxxxxxxxxxxxxxxxxx', 99.5, 2);
+INSERT INTO t VALUES (500, 'n500xxxxxxxxxxxxxxxxxxxx', 0.5, 3), (501, 'n501xxxxxxxxxxxxxxxxxxxxx', 1.5, 4), (502, 'n502xxxxxxxxxxxxxxxxxxxxxx', 2.5, 5), (503, 'n503xxxxxxxxxxxxxxxxxxxxxxx', 3.5, 6), (504, 'n504xxxxxxxxxxxxxxxxxxxxxxxx', 4.5, 0), (505, 'n505xxxxxxxxxxxxxxxxxxxxxxxxx', 5.5, 1), (506, 'n506xxxxxxxxxxxxxxxxxxxxxxxxxx', 6.5, 2), (507, 'n507xxxxxxxxxxxxxxxxxxxxxxxxxxx', 7.5, 3), (508, 'n508xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 8.5, 4), (509, 'n509xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 9.5, 5), (510, 'n510xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 10.5, 6), (511, 'n511xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 11.5, 0), (512, 'n512xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 12.5, 1), (513, 'n513xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 13.5, 2), (514, 'n514xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 14.5, 3), (515, 'n515xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 15.5, 4), (516, 'n516xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 16.5, 5), (517, 'n517xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 17.5, 6), (518, 'n518xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 18.5, 0), (519, 'n519xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 19.5, 1), (520, 'n520', 20.5, 2), (521, 'n521x', 21.5, 3), (522, 'n522xx', 22.5, 4), (523, 'n523xxx', 23.5, 5), (524, 'n524xxxx', 24.5, 6), (525, 'n525xxxxx', 25.5, 0), (526, 'n526xxxxxx', 26.5, 1), (527, 'n527xxxxxxx', 27.5, 2), (528, 'n528xxxxxxxx', 28.5, 3), (529, 'n529xxxxxxxxx', 29.5, 4), (530, 'n530xxxxxxxxxx', 30.5, 5), (531, 'n531xxxxxxxxxxx', 31.5, 6), (532, 'n532xxxxxxxxxxxx', 32.5, 0), (533, 'n533xxxxxxxxxxxxx', 33.5, 1), (534, 'n534xxxxxxxxxxxxxx', 34.5, 2), (535, 'n535xxxxxxxxxxxxxxx', 35.5, 3), (536, 'n536xxxxxxxxxxxxxxxx', 36.5, 4), (537, 'n537xxxxxxxxxxxxxxxxx', 37.5, 5), (538, 'n538xxxxxxxxxxxxxxxxxx', 38.5, 6), (539, 'n539xxxxxxxxxxxxxxxxxxx', 39.5, 0), (540, 'n540xxxxxxxxxxxxxxxxxxxx', 40.5, 1), (541, 'n541xxxxxxxxxxxxxxxxxxxxx', 41.5, 2), (542, 'n542xxxxxxxxxxxxxxxxxxxxxx', 42.5, 3), (543, 'n543xxxxxxxxxxxxxxxxxxxxxxx', 43.5, 4), (544, 'n544xxxxxxxxxxxxxxxxxxxxxxxx', 44.5, 5), (545, 'n545xxxxxxxxxxxxxxxxxxxxxxxxx', 45.5, 6), (546, 'n546xxxxxxxxxxxxxxxxxxxxxxxxxx', 46.5, 0), (547, 'n547xxxxxxxxxxxxxxxxxxxxxxxxxxx', 47.5, 1), (548, 'n548xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 48.5, 2), (549, 'n549xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 49.5, 3), (550, 'n550xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 50.5, 4), (551, 'n551xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 51.5, 5), (552, 'n552xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 52.5, 6), (553, 'n553xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 53.5, 0), (554, 'n554xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 54.5, 1), (555, 'n555xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 55.5, 2), (556, 'n556xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 56.5, 3), (557, 'n557xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 57.5, 4), (558, 'n558xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 58.5, 5), (559, 'n559xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 59.5, 6), (560, 'n560', 60.5, 0), (561, 'n561x', 61.5, 1), (562, 'n562xx', 62.5, 2), (563, 'n563xxx', 63.5, 3), (564, 'n564xxxx', 64.5, 4), (565, 'n565xxxxx', 65.5, 5), (566, 'n566xxxxxx', 66.5, 6), (567, 'n567xxxxxxx', 67.5, 0), (568, 'n568xxxxxxxx', 68.5, 1), (569, 'n569xxxxxxxxx', 69.5, 2), (570, 'n570xxxxxxxxxx', 70.5, 3), (571, 'n571xxxxxxxxxxx', 71.5, 4), (572, 'n572xxxxxxxxxxxx', 72.5, 5), (573, 'n573xxxxxxxxxxxxx', 73.5, 6), (574, 'n574xxxxxxxxxxxxxx', 74.5, 0), (575, 'n575xxxxxxxxxxxxxxx', 75.5, 1), (576, 'n576xxxxxxxxxxxxxxxx', 76.5, 2), (577, 'n577xxxxxxxxxxxxxxxxx', 77.5, 3), (578, 'n578xxxxxxxxxxxxxxxxxx', 78.5, 4), (579, 'n579xxxxxxxxxxxxxxxxxxx', 79.5, 5), (580, 'n580xxxxxxxxxxxxxxxxxxxx', 80.5, 6), (581, 'n581xxxxxxxxxxxxxxxxxxxxx', 81.5, 0), (582, 'n582xxxxxxxxxxxxxxxxxxxxxx', 82.5, 1), (583, 'n583xxxxxxxxxxxxxxxxxxxxxxx', 83.5, 2), (584, 'n584xxxxxxxxxxxxxxxxxxxxxxxx', 84.5, 3), (585, 'n585xxxxxxxxxxxxxxxxxxxxxxxxx', 85.5, 4), (586, 'n586xxxxxxxxxxxxxxxxxxxxxxxxxx', 86.5, 5), (587, 'n587xxxxxxxxxxxxxxxxxxxxxxxxxxx', 87.5, 6), (588, 'n588xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 88.5, 0), (589, 'n589xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 89.5, 1), (590, 'n590xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 90.5, 2), (591, 'n591xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 91.5, 3), (592, 'n592xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 92.5, 4), (593, 'n593xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 93.5, 5), (594, 'n594xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 94.5, 6), (595, 'n595xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 95.5, 0), (596, 'n596xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 96.5, 1), (597, 'n597xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 97.5, 2), (598, 'n598xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 98.5, 3), (599, 'n599xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 99.5, 4);
+INSERT INTO t VALUES (600, 'n600', 0.5, 5), (601, 'n601x', 1.5, 6), (602, 'n602xx', 2.5, 0), (603, 'n603xxx', 3.5, 1), (604, 'n604xxxx', 4.5, 2), (605, 'n605xxxxx', 5.5, 3), (606, 'n606xxxxxx', 6.5, 4), (607, 'n607xxxxxxx', 7.5, 5), (608, 'n608xxxxxxxx', 8.5, 6), (609, 'n609xxxxxxxxx', 9.5, 0), (610, 'n610xxxxxxxxxx', 10.5, 1), (611, 'n611xxxxxxxxxxx', 11.5, 2), (612, 'n612xxxxxxxxxxxx', 12.5, 3), (613, 'n613xxxxxxxxxxxxx', 13.5, 4), (614, 'n614xxxxxxxxxxxxxx', 14.5, 5), (615, 'n615xxxxxxxxxxxxxxx', 15.5, 6), (616, 'n616xxxxxxxxxxxxxxxx', 16.5, 0), (617, 'n617xxxxxxxxxxxxxxxxx', 17.5, 1), (618, 'n618xxxxxxxxxxxxxxxxxx', 18.5, 2), (619, 'n619xxxxxxxxxxxxxxxxxxx', 19.5, 3), (620, 'n620xxxxxxxxxxxxxxxxxxxx', 20.5, 4), (621, 'n621xxxxxxxxxxxxxxxxxxxxx', 21.5, 5), (622, 'n622xxxxxxxxxxxxxxxxxxxxxx', 22.5, 6), (623, 'n623xxxxxxxxxxxxxxxxxxxxxxx', 23.5, 0), (624, 'n624xxxxxxxxxxxxxxxxxxxxxxxx', 24.5, 1), (625, 'n625xxxxxxxxxxxxxxxxxxxxxxxxx', 25.5, 2), (626, 'n626xxxxxxxxxxxxxxxxxxxxxxxxxx', 26.5, 3), (627, 'n627xxxxxxxxxxxxxxxxxxxxxxxxxxx', 27.5, 4), (628, 'n628xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 28.5, 5), (629, 'n629xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 29.5, 6), (630, 'n630xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 30.5, 0), (631, 'n631xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 31.5, 1), (632, 'n632xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 32.5, 2), (633, 'n633xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 33.5, 3), (634, 'n634xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 34.5, 4), (635, 'n635xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 35.5, 5), (636, 'n636xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 36.5, 6), (637, 'n637xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 37.5, 0), (638, 'n638xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 38.5, 1), (639, 'n639xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 39.5, 2), (640, 'n640', 40.5, 3), (641, 'n641x', 41.5, 4), (642, 'n642xx', 42.5, 5), (643, 'n643xxx', 43.5, 6), (644, 'n644xxxx', 44.5, 0), (645, 'n645xxxxx', 45.5, 1), (646, 'n646xxxxxx', 46.5, 2), (647, 'n647xxxxxxx', 47.5, 3), (648, 'n648xxxxxxxx', 48.5, 4), (649, 'n649xxxxxxxxx', 49.5, 5), (650, 'n650xxxxxxxxxx', 50.5, 6), (651, 'n651xxxxxxxxxxx', 51.5, 0), (652, 'n652xxxxxxxxxxxx', 52.5, 1), (653, 'n653xxxxxxxxxxxxx', 53.5, 2), (654, 'n654xxxxxxxxxxxxxx', 54.5, 3), (655, 'n655xxxxxxxxxxxxxxx', 55.5, 4), (656, 'n656xxxxxxxxxxxxxxxx', 56.5, 5), (657, 'n657xxxxxxxxxxxxxxxxx', 57.5, 6), (658, 'n658xxxxxxxxxxxxxxxxxx', 58.5, 0), (659, 'n659xxxxxxxxxxxxxxxxxxx', 59.5, 1), (660, 'n660xxxxxxxxxxxxxxxxxxxx', 60.5, 2), (661, 'n661xxxxxxxxxxxxxxxxxxxxx', 61.5, 3), (662, 'n662xxxxxxxxxxxxxxxxxxxxxx', 62.5, 4), (663, 'n663xxxxxxxxxxxxxxxxxxxxxxx', 63.5, 5), (664, 'n664xxxxxxxxxxxxxxxxxxxxxxxx', 64.5, 6), (665, 'n665xxxxxxxxxxxxxxxxxxxxxxxxx', 65.5, 0), (666, 'n666xxxxxxxxxxxxxxxxxxxxxxxxxx', 66.5, 1), (667, 'n667xxxxxxxxxxxxxxxxxxxxxxxxxxx', 67.5, 2), (668, 'n668xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 68.5, 3), (669, 'n669xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 69.5, 4), (670, 'n670xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 70.5, 5), (671, 'n671xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 71.5, 6), (672, 'n672xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 72.5, 0), (673, 'n673xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 73.5, 1), (674, 'n674xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 74.5, 2), (675, 'n675xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 75.5, 3), (676, 'n676xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 76.5, 4), (677, 'n677xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 77.5, 5), (678, 'n678xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 78.5, 6), (679, 'n679xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 79.5, 0), (680, 'n680', 80.5, 1), (681, 'n681x', 81.5, 2), (682, 'n682xx', 82.5, 3), (683, 'n683xxx', 83.5, 4), (684, 'n684xxxx', 84.5, 5), (685, 'n685xxxxx', 85.5, 6), (686, 'n686xxxxxx', 86.5, 0), (687, 'n687xxxxxxx', 87.5, 1), (688, 'n688xxxxxxxx', 88.5, 2), (689, 'n689xxxxxxxxx', 89.5, 3), (690, 'n690xxxxxxxxxx', 90.5, 4), (691, 'n691xxxxxxxxxxx', 91.5, 5), (692, 'n692xxxxxxxxxxxx', 92.5, 6), (693, 'n693xxxxxxxxxxxxx', 93.5, 0), (694, 'n694xxxxxxxxxxxxxx', 94.5, 1), (695, 'n695xxxxxxxxxxxxxxx', 95.5, 2), (696, 'n696xxxxxxxxxxxxxxxx', 96.5, 3), (697, 'n697xxxxxxxxxxxxxxxxx', 97.5, 4), (698, 'n698xxxxxxxxxxxxxxxxxx', 98.5, 5), (699, 'n699xxxxxxxxxxxxxxxxxxx', 99.5, 6);
+INSERT INTO t VALUES (700, 'n700xxxxxxxxxxxxxxxxxxxx', 0.5, 0), (701, 'n701xxxxxxxxxxxxxxxxxxxxx', 1.5, 1), (702, 'n702xxxxxxxxxxxxxxxxxxxxxx', 2.5, 2), (703, 'n703xxxxxxxxxxxxxxxxxxxxxxx', 3.5, 3), (704, 'n704xxxxxxxxxxxxxxxxxxxxxxxx', 4.5, 4), (705, 'n705xxxxxxxxxxxxxxxxxxxxxxxxx', 5.5, 5), (706, 'n706xxxxxxxxxxxxxxxxxxxxxxxxxx', 6.5, 6), (707, 'n707xxxxxxxxxxxxxxxxxxxxxxxxxxx', 7.5, 0), (708, 'n708xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 8.5, 1), (709, 'n709xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 9.5, 2), (710, 'n710xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 10.5, 3), (711, 'n711xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 11.5, 4), (712, 'n712xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 12.5, 5), (713, 'n713xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 13.5, 6), (714, 'n714xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 14.5, 0), (715, 'n715xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 15.5, 1), (716, 'n716xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 16.5, 2), (717, 'n717xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 17.5, 3), (718, 'n718xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 18.5, 4), (719, 'n719xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 19.5, 5), (720, 'n720', 20.5, 6), (721, 'n721x', 21.5, 0), (722, 'n722xx', 22.5, 1), (723, 'n723xxx', 23.5, 2), (724, 'n724xxxx', 24.5, 3), (725, 'n725xxxxx', 25.5, 4), (726, 'n726xxxxxx', 26.5, 5), (727, 'n727xxxxxxx', 27.5, 6), (728, 'n728xxxxxxxx', 28.5, 0), (729, 'n729xxxxxxxxx', 29.5, 1), (730, 'n730xxxxxxxxxx', 30.5, 2), (731, 'n731xxxxxxxxxxx', 31.5, 3), (732, 'n732xxxxxxxxxxxx', 32.5, 4), (733, 'n733xxxxxxxxxxxxx', 33.5, 5), (734, 'n734xxxxxxxxxxxxxx', 34.5, 6), (735, 'n735xxxxxxxxxxxxxxx', 35.5, 0), (736, 'n736xxxxxxxxxxxxxxxx', 36.5, 1), (737, 'n737xxxxxxxxxxxxxxxxx', 37.5, 2), (738, 'n738xxxxxxxxxxxxxxxxxx', 38.5, 3), (739, 'n739xxxxxxxxxxxxxxxxxxx', 39.5, 4), (740, 'n740xxxxxxxxxxxxxxxxxxxx', 40.5, 5), (741, 'n741xxxxxxxxxxxxxxxxxxxxx', 41.5, 6), (742, 'n742xxxxxxxxxxxxxxxxxxxxxx', 42.5, 0), (743, 'n743xxxxxxxxxxxxxxxxxxxxxxx', 43.5, 1), (744, 'n744xxxxxxxxxxxxxxxxxxxxxxxx', 44.5, 2), (745, 'n745xxxxxxxxxxxxxxxxxxxxxxxxx', 45.5, 3), (746, 'n746xxxxxxxxxxxxxxxxxxxxxxxxxx', 46.5, 4), (747, 'n747xxxxxxxxxxxxxxxxxxxxxxxxxxx', 47.5, 5), (748, 'n748xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 48.5, 6), (749, 'n749xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 49.5, 0), (750, 'n750xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 50.5, 1), (751, 'n751xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 51.5, 2), (752, 'n752xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 52.5, 3), (753, 'n753xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 53.5, 4), (754, 'n754xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 54.5, 5), (755, 'n755xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 55.5, 6), (756, 'n756xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 56.5, 0), (757, 'n757xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 57.5, 1), (758, 'n758xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 58.5, 2), (759, 'n759xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 59.5, 3), (760, 'n760', 60.5, 4), (761, 'n761x', 61.5, 5), (762, 'n762xx', 62.5, 6), (763, 'n763xxx', 63.5, 0), (764, 'n764xxxx', 64.5, 1), (765, 'n765xxxxx', 65.5, 2), (766, 'n766xxxxxx', 66.5, 3), (767, 'n767xxxxxxx', 67.5, 4), (768, 'n768xxxxxxxx', 68.5, 5), (769, 'n769xxxxxxxxx', 69.5, 6), (770, 'n770xxxxxxxxxx', 70.5, 0), (771, 'n771xxxxxxxxxxx', 71.5, 1), (772, 'n772xxxxxxxxxxxx', 72.5, 2), (773, 'n773xxxxxxxxxxxxx', 73.5, 3), (774, 'n774xxxxxxxxxxxxxx', 74.5, 4), (775, 'n775xxxxxxxxxxxxxxx', 75.5, 5), (776, 'n776xxxxxxxxxxxxxxxx', 76.5, 6), (777, 'n777xxxxxxxxxxxxxxxxx', 77.5, 0), (778, 'n778xxxxxxxxxxxxxxxxxx', 78.5, 1), (779, 'n779xxxxxxxxxxxxxxxxxxx', 79.5, 2), (780, 'n780xxxxxxxxxxxxxxxxxxxx', 80.5, 3), (781, 'n781xxxxxxxxxxxxxxxxxxxxx', 81.5, 4), (782, 'n782xxxxxxxxxxxxxxxxxxxxxx', 82.5, 5), (783, 'n783xxxxxxxxxxxxxxxxxxxxxxx', 83.5, 6), (784, 'n784xxxxxxxxxxxxxxxxxxxxxxxx', 84.5, 0), (785, 'n785xxxxxxxxxxxxxxxxxxxxxxxxx', 85.5, 1), (786, 'n786xxxxxxxxxxxxxxxxxxxxxxxxxx', 86.5, 2), (787, 'n787xxxxxxxxxxxxxxxxxxxxxxxxxxx', 87.5, 3), (788, 'n788xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 88.5, 4), (789, 'n789xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 89.5, 5), (790, 'n790xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 90.5, 6), (791, 'n791xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 91.5, 0), (792, 'n792xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 92.5, 1), (793, 'n793xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 93.5, 2), (794, 'n794xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 94.5, 3), (795, 'n795xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 95.5, 4), (796, 'n796xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 96.5, 5), (797, 'n797xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 97.5, 6), (798, 'n798xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 98.5, 0), (799, 'n799xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 99.5, 1);
+CREATE INDEX ci ON t (c);
+DESC t;
+DELETE FROM t WHERE c = 3;
+DELETE FROM t WHERE id >= 700;
+UPDATE t SET score = 1.25, name = 'renamed' WHERE id = 11;
+UPDATE t SET c = 3 WHERE id = 12;
+SELECT * FROM t WHERE id = 11;
+SELECT * FROM t WHERE c = 3;
+SELECT * FROM t WHERE id >= 690;
+SELECT * FROM t WHERE id = 18;
+VACUUM t;
+DESC t;
+SELECT * FROM t WHERE c = 3;
+SELECT * FROM t WHERE id >= 690;
+SELECT * FROM t WHERE id < 8;
+INSERT INTO t VALUES (700, 'n700xxxxxxxxxxxxxxxxxxxx', 0.5, 0), (701, 'n701xxxxxxxxxxxxxxxxxxxxx', 1.5, 1), (702, 'n702xxxxxxxxxxxxxxxxxxxxxx', 2.5, 2), (703, 'n703xxxxxxxxxxxxxxxxxxxxxxx', 3.5, 3), (704, 'n704xxxxxxxxxxxxxxxxxxxxxxxx', 4.5, 4), (705, 'n705xxxxxxxxxxxxxxxxxxxxxxxxx', 5.5, 5), (706, 'n706xxxxxxxxxxxxxxxxxxxxxxxxxx', 6.5, 6), (707, 'n707xxxxxxxxxxxxxxxxxxxxxxxxxxx', 7.5, 0), (708, 'n708xxxxxxxxxxxxxxxxxxxxxxxxxxxx', 8.5, 1), (709, 'n709xxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 9.5, 2), (710, 'n710xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 10.5, 3), (711, 'n711xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 11.5, 4), (712, 'n712xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 12.5, 5), (713, 'n713xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 13.5, 6), (714, 'n714xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 14.5, 0), (715, 'n715xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 15.5, 1), (716, 'n716xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 16.5, 2), (717, 'n717xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 17.5, 3), (718, 'n718xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 18.5, 4), (719, 'n719xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx', 19.5, 5);
+INSERT INTO t VALUES (5, 'dup', 0.5, 0);
+SELECT * FROM t WHERE id >= 710;
+SELECT * FROM t WHERE c = 3 AND id < 100;
+DROP DATABASE regress;
@@ -0,0 +1,13 @@
+/* 自引用外键：检查须经由插入所用的同一句柄，终端另开的句柄看不到本句柄缓存的元信息 */
+CREATE DATABASE regress;
+USE regress;
+CREATE TABLE emp (id INT NOT NULL, boss INT, PRIMARY KEY (id), FOREIGN KEY (boss) REFERENCES emp(id));
+INSERT INTO emp VALUES (1, NULL);
+INSERT INTO emp VALUES (2, 1);
+INSERT INTO emp VALUES (3, 9);
+INSERT INTO emp VALUES (4, 2);
+SELECT * FROM emp;
+DELETE FROM emp WHERE id = 4;
+INSERT INTO emp VALUES (5, 4);
+INSERT INTO emp VALUES (5, 2);
+SELECT * FROM emp;
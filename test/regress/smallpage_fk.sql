@@ -0,0 +1,34 @@
+/* 4 KB 页面上外键只有约 1 KB 空间：放不下的外键须报错，已有外键保持完整 */
+CREATE DATABASE regress PAGESIZE 4096;
+USE regress;
+CREATE TABLE p (id INT(10), PRIMARY KEY (id));
+CREATE TABLE c (a INT(10));
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_00 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_01 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_02 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_03 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_04 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_05 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_06 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_07 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_08 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_09 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_10 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_11 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_12 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_13 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_14 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_15 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_16 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_17 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_18 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_19 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_20 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_21 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_22 FOREIGN KEY (a) REFERENCES p(id);
+ALTER TABLE c ADD CONSTRAINT fk_constraint_with_long_name_23 FOREIGN KEY (a) REFERENCES p(id);
+DESC c;
+ALTER TABLE c DROP FOREIGN KEY fk_constraint_with_long_name_00;
+ALTER TABLE c ADD CONSTRAINT fk_short FOREIGN KEY (a) REFERENCES p(id);
+DESC c;
+DROP DATABASE regress;
@@ -0,0 +1,78 @@
+/* 4 KB 页面上的宽索引键：每个节点放不下三个条目的主键与索引须在定义时拒绝，边界以内的键可正常分裂 */
+CREATE DATABASE regress PAGESIZE 4096;
+USE regress;
+CREATE TABLE w (k VARCHAR(1500), v INT(10), PRIMARY KEY (k));
+CREATE TABLE t (k VARCHAR(1005), v INT(10), PRIMARY KEY (k));
+DESC w;
+CREATE INDEX kv ON t (k, v);
+ALTER TABLE t DROP PRIMARY KEY;
+ALTER TABLE t ADD PRIMARY KEY (k, v);
+ALTER TABLE t ADD PRIMARY KEY (k);
+CREATE INDEX vi ON t (v);
+INSERT INTO t VALUES ('key000', 0);
+INSERT INTO t VALUES ('key037', 1);
+INSERT INTO t VALUES ('key014', 2);
+INSERT INTO t VALUES ('key051', 3);
+INSERT INTO t VALUES ('key028', 4);
+INSERT INTO t VALUES ('key005', 5);
+INSERT INTO t VALUES ('key042', 6);
+INSERT INTO t VALUES ('key019', 7);
+INSERT INTO t VALUES ('key056', 8);
+INSERT INTO t VALUES ('key033', 9);
+INSERT INTO t VALUES ('key010', 10);
+INSERT INTO t VALUES ('key047', 11);
+INSERT INTO t VALUES ('key024', 12);
+INSERT INTO t VALUES ('key001', 13);
+INSERT INTO t VALUES ('key038', 14);
+INSERT INTO t VALUES ('key015', 15);
+INSERT INTO t VALUES ('key052', 16);
+INSERT INTO t VALUES ('key029', 17);
+INSERT INTO t VALUES ('key006', 18);
+INSERT INTO t VALUES ('key043', 19);
+INSERT INTO t VALUES ('key020', 20);
+INSERT INTO t VALUES ('key057', 21);
+INSERT INTO t VALUES ('key034', 22);
+INSERT INTO t VALUES ('key011', 23);
+INSERT INTO t VALUES ('key048', 24);
+INSERT INTO t VALUES ('key025', 25);
+INSERT INTO t VALUES ('key002', 26);
+INSERT INTO t VALUES ('key039', 27);
+INSERT INTO t VALUES ('key016', 28);
+INSERT INTO t VALUES ('key053', 29);
+INSERT INTO t VALUES ('key030', 30);
+INSERT INTO t VALUES ('key007', 31);
+INSERT INTO t VALUES ('key044', 32);
+INSERT INTO t VALUES ('key021', 33);
+INSERT INTO t VALUES ('key058', 34);
+INSERT INTO t VALUES ('key035', 35);
+INSERT INTO t VALUES ('key012', 36);
+INSERT INTO t VALUES ('key049', 37);
+INSERT INTO t VALUES ('key026', 38);
+INSERT INTO t VALUES ('key003', 39);
+INSERT INTO t VALUES ('key040', 40);
+INSERT INTO t VALUES ('key017', 41);
+INSERT INTO t VALUES ('key054', 42);
+INSERT INTO t VALUES ('key031', 43);
+INSERT INTO t VALUES ('key008', 44);
+INSERT INTO t VALUES ('key045', 45);
+INSERT INTO t VALUES ('key022', 46);
+INSERT INTO t VALUES ('key059', 47);
+INSERT INTO t VALUES ('key036', 48);
+INSERT INTO t VALUES ('key013', 49);
+INSERT INTO t VALUES ('key050', 50);
+INSERT INTO t VALUES ('key027', 51);
+INSERT INTO t VALUES ('key004', 52);
+INSERT INTO t VALUES ('key041', 53);
+INSERT INTO t VALUES ('key018', 54);
+INSERT INTO t VALUES ('key055', 55);
+INSERT INTO t VALUES ('key032', 56);
+INSERT INTO t VALUES ('key009', 57);
+INSERT INTO t VALUES ('key046', 58);
+INSERT INTO t VALUES ('key023', 59);
+SELECT * FROM t WHERE k = 'key017';
+SELECT * FROM t WHERE k >= 'key057';
+DELETE FROM t WHERE k < 'key050';
+SELECT * FROM t WHERE k < 'key052';
+SELECT * FROM t WHERE v = 59;
+DESC t;
+DROP DATABASE regress;
@@ -1,68 +1,73 @@
 #ifndef __HASH_MAP_H__
 #define __HASH_MAP_H__
 
-#include "MultiList.h"
+#include <cassert>
 
+/* 页表：由 (文件编号, 页号) 查找缓存页面编号。
+ * 键不另存，直接取自页面描述 Frame 的 fileID 与 pageID，槽中只存 4 字节的页面编号，
+ * 命中时比较的正是随后要访问的页面描述。开放寻址、线性探测，槽数为不小于容量两倍的 2 的幂，
+ * 负载因子不超过 1/2；删除时后移填补空位，不留墓碑。
+ */
+template <typename Frame>
 class HashMap {
 private:
-    struct DataNode {
-        int key1, key2;
-    };
-    static const int base = 97;
-    static const int mod = 48611; // prime[5000]
-    int cap;
-    MultiList *list;
-    DataNode *a;
+    const Frame *frames;
+    unsigned mask;
+    int shift; // 64 减去槽数的对数，乘法散列取乘积的高位
+    int *a;    // -1 表示空槽
 
-    int hash(int k1, int k2) {
-        return (k1 + (long long) k2 * base) % mod;
+    unsigned hash(int k1, int k2) {
+        unsigned long long key = ((unsigned long long) (unsigned) k1 << 32) | (unsigned) k2;
+        return (unsigned) ((key * 0x9E3779B97F4A7C15ULL) >> shift);
+    }
+
+    unsigned probe(int k1, int k2) {
+        unsigned p = hash(k1, k2);
+        while (a[p] != -1 && (frames[a[p]].fileID != k1 || frames[a[p]].pageID != k2))
+            p = (p + 1) & mask;
+        return p;
     }
 
 public:
-    HashMap(int c) {
-        cap = c;
-        a = new DataNode[c];
-        for (int i = 0; i < cap; i++) {
-            a[i].key1 = -1;
-            a[i].key2 = -1;
-        }
-        list = new MultiList(cap, mod);
+    HashMap(int c, const Frame *f) {
+        frames = f;
+        unsigned size = 2;
+        shift = 63;
+        while (size < (unsigned) c * 2) size <<= 1, shift--;
+        mask = size - 1;
+        a = new int[size];
+        for (unsigned i = 0; i < size; i++) a[i] = -1;
     }
 
     ~HashMap() {
-        delete list;
         delete[] a;
     }
 
     // return -1 when fail
     int findIndex(int k1, int k2) {
-        int h = hash(k1, k2);
-        int p = list->getFirst(h);
-        while (!list->isHead(p)) {
-            if (a[p].key1 == k1 && a[p].key2 == k2) {
-                return p;
-            }
-            p = list->next(p);
-        }
-        return -1;
+        return a[probe(k1, k2)];
     }
 
-    void replace(int index, int k1, int k2) {
-        int h = hash(k1, k2);
-        list->insertFirst(h, index);
-        a[index].key1 = k1;
-        a[index].key2 = k2;
+    // 加入页面，其描述中须已填好键。
+    void insert(int index) {
+        unsigned p = probe(frames[index].fileID, frames[index].pageID);
+        assert(a[p] == -1);
+        a[p] = index;
     }
 
+    // 移除页面，须在改写其描述中的键之前调用。
     void erase(int index) {
-        list->erase(index);
-        a[index].key1 = -1;
-        a[index].key2 = -1;
-    }
-
-    void getKeys(int index, int &k1, int &k2) {
-        k1 = a[index].key1;
-        k2 = a[index].key2;
+        unsigned p = probe(frames[index].fileID, frames[index].pageID);
+        if (a[p] != index) return;
+        // 将其后探测链上的元素前移，保证查找不会提前遇到空槽
+        for (unsigned q = (p + 1) & mask; a[q] != -1; q = (q + 1) & mask) {
+            unsigned h = hash(frames[a[q]].fileID, frames[a[q]].pageID);
+            if (((q - h) & mask) >= ((q - p) & mask)) {
+                a[p] = a[q];
+                p = q;
+            }
+        }
+        a[p] = -1;
     }
 
 };